@@ -17,6 +17,9 @@ class Namespace(argparse.Namespace):
         reset_after_factor: int
         diversification_factor: float
         max_elite_size: int
+        extra_initial: int
+        cross_exchange_length: int
+        proximity_factor: float
         verbose: bool
 
 
@@ -32,6 +35,9 @@ parser.add_argument("--range-type", default="low", choices=["low", "high"], help
 parser.add_argument("--reset-after-factor", default=30, type=int, help="the number of non-improved iterations before resetting the current solution = a1 * base")
 parser.add_argument("--diversification-factor", default=0, type=float, help="the number of iterations to apply diversification = a2 * base")
 parser.add_argument("--max-elite-size", default=5, type=int, help="the maximum size of the elite set = a3")
+parser.add_argument("--extra-initial", default=0, type=int, help="the number of additional randomized initial solutions to construct concurrently")
+parser.add_argument("--cross-exchange-length", default=3, type=int, help="the maximum length of exchanged segments in CROSS-exchange, 0 for no limit")
+parser.add_argument("--proximity-factor", default=0, type=float, help="the maximum separation of route pairs considered by inter-route neighborhoods = a4 * average distance, 0 for no limit")
 parser.add_argument("-v", "--verbose", action="store_true", help="the verbose mode")
 
 
@@ -110,4 +116,4 @@ if __name__ == "__main__":
             model.drone_speed,
         )
 
-    print(namespace.max_elite_size, namespace.reset_after_factor, namespace.diversification_factor)
+    print(namespace.max_elite_size, namespace.reset_after_factor, namespace.diversification_factor, namespace.extra_initial, namespace.cross_exchange_length, namespace.proximity_factor)
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "utils.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A bump allocator for short-lived scratch data, usable through `std::pmr` containers.
+     *
+     * Allocation only advances a pointer inside the current block, and deallocation is a no-op. Memory is
+     * reclaimed all at once by `rewind` or `reset`, which keep the blocks for later use, so that a warmed-up arena
+     * never calls `malloc`.
+     */
+    class Arena : public std::pmr::memory_resource
+    {
+    private:
+        static constexpr std::size_t _block_size = 1 << 16;
+
+        struct _Block
+        {
+            std::unique_ptr<std::byte[]> data;
+            std::size_t size;
+        };
+
+        std::vector<_Block> _blocks;
+        std::size_t _block = 0, _offset = 0;
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            while (true)
+            {
+                if (_block == _blocks.size())
+                {
+                    const auto size = std::max(_block_size, bytes + alignment);
+                    _blocks.push_back({std::make_unique<std::byte[]>(size), size});
+                }
+
+                auto &block = _blocks[_block];
+                const auto address = reinterpret_cast<std::uintptr_t>(block.data.get()) + _offset;
+                const auto start = _offset + (alignment - address % alignment) % alignment;
+                if (start + bytes <= block.size)
+                {
+                    _offset = start + bytes;
+                    return block.data.get() + start;
+                }
+
+                _block++;
+                _offset = 0;
+            }
+        }
+
+        void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    public:
+        /** @brief A position in the arena, all memory allocated after which can be reclaimed at once. */
+        using Marker = std::pair<std::size_t, std::size_t>;
+
+        /**
+         * @brief Reclaim all memory allocated since `marker` when going out of scope.
+         *
+         * Containers using the arena must not outlive the scope they were created in.
+         */
+        class Scope
+        {
+        private:
+            Arena &_arena;
+            const Marker _marker;
+
+        public:
+            explicit Scope(Arena &arena) : _arena(arena), _marker(arena.mark()) {}
+
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+            ~Scope()
+            {
+                _arena.rewind(_marker);
+            }
+        };
+
+        Arena() = default;
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        /** @brief The arena of the calling thread. */
+        static Arena &local()
+        {
+            thread_local Arena arena;
+            return arena;
+        }
+
+        Marker mark() const
+        {
+            return std::make_pair(_block, _offset);
+        }
+
+        void rewind(const Marker &marker)
+        {
+            std::tie(_block, _offset) = marker;
+        }
+
+        /** @brief Reclaim all memory of this arena. */
+        void reset()
+        {
+            rewind(std::make_pair(0, 0));
+        }
+    };
+}
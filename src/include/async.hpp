@@ -0,0 +1,121 @@
+#pragma once
+
+#include "format.hpp"
+
+namespace utils
+{
+    /**
+     * @brief Run tasks concurrently and retrieve their results in order of completion.
+     *
+     * @tparam T The result type of submitted tasks
+     */
+    template <typename T>
+    class CompletionQueue
+    {
+    private:
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::deque<T> _ready;
+        std::exception_ptr _error;
+        std::size_t _pending = 0;
+
+        std::vector<std::future<void>> _futures;
+
+        void _rethrow()
+        {
+            if (_error != nullptr)
+            {
+                auto error = _error;
+                _error = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+    public:
+        CompletionQueue() = default;
+        CompletionQueue(const CompletionQueue &) = delete;
+        CompletionQueue &operator=(const CompletionQueue &) = delete;
+
+        ~CompletionQueue()
+        {
+            for (auto &future : _futures)
+            {
+                future.wait();
+            }
+        }
+
+        /** @brief Start a task in a new thread. */
+        template <typename _Callable>
+        void submit(_Callable task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _pending++;
+            }
+
+            _futures.push_back(
+                std::async(
+                    std::launch::async,
+                    [this, task]()
+                    {
+                        try
+                        {
+                            T result = task();
+
+                            std::lock_guard<std::mutex> lock(_mutex);
+                            _ready.push_back(std::move(result));
+                            _pending--;
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard<std::mutex> lock(_mutex);
+                            _error = std::current_exception();
+                            _pending--;
+                        }
+
+                        _condition.notify_all();
+                    }));
+        }
+
+        /** @brief Whether all submitted tasks have finished and their results have been retrieved. */
+        bool empty()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _pending == 0 && _ready.empty();
+        }
+
+        /**
+         * @brief Block until a task finishes, then return its result.
+         *
+         * @return The result of the earliest finished task which has not been retrieved yet, or `std::nullopt`
+         * if there is no such task.
+         */
+        std::optional<T> wait()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]()
+                            { return !_ready.empty() || _pending == 0 || _error != nullptr; });
+
+            _rethrow();
+            if (_ready.empty())
+            {
+                return std::nullopt;
+            }
+
+            T result = std::move(_ready.front());
+            _ready.pop_front();
+            return result;
+        }
+
+        /** @brief Retrieve the results of all finished tasks without blocking. */
+        std::vector<T> poll()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _rethrow();
+
+            std::vector<T> results(std::make_move_iterator(_ready.begin()), std::make_move_iterator(_ready.end()));
+            _ready.clear();
+            return results;
+        }
+    };
+}
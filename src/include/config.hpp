@@ -17,6 +17,9 @@ namespace d2d
         const double capacity;
         const double average_speed;
 
+        /** @brief The speed in the fastest time period */
+        const double maximum_speed;
+
         TruckConfig(
             const double &maximum_velocity,
             const std::vector<double> &coefficients,
@@ -24,7 +27,8 @@ namespace d2d
             : _maximum_velocity(maximum_velocity),
               _coefficients(coefficients),
               capacity(capacity),
-              average_speed(maximum_velocity * std::accumulate(coefficients.begin(), coefficients.end(), 0.0) / coefficients.size())
+              average_speed(maximum_velocity * std::accumulate(coefficients.begin(), coefficients.end(), 0.0) / coefficients.size()),
+              maximum_speed(maximum_velocity * *std::max_element(coefficients.begin(), coefficients.end()))
         {
         }
 
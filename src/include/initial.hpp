@@ -1,8 +1,11 @@
 #pragma once
 
+#include "insertion.hpp"
+#include "kmeans.hpp"
 #include "parent.hpp"
 #include "random.hpp"
 #include "routes.hpp"
+#include "spatial.hpp"
 
 namespace d2d
 {
@@ -21,6 +24,19 @@ namespace d2d
         std::vector<std::vector<TruckRoute>> &truck_routes,
         std::vector<std::vector<DroneRoute>> &drone_routes)
     {
+        if constexpr (std::is_same_v<RT, DroneRoute>)
+        {
+            auto problem = Problem::get_instance();
+            const auto &customers = route.customers();
+            if (std::any_of(
+                    customers.begin() + 1, customers.end() - 1,
+                    [&problem, &customer](const std::size_t &c)
+                    { return !problem->drone_compatible[customer][c]; }))
+            {
+                return false;
+            }
+        }
+
         RT old = route;
         route.push_back(customer);
 
@@ -51,66 +67,119 @@ namespace d2d
         return false;
     }
 
-    template <typename ST>
-    void _insert_leftover(
-        const std::vector<std::size_t> &leftover,
-        std::vector<std::vector<TruckRoute>> &truck_routes,
-        const std::vector<std::vector<DroneRoute>> &drone_routes)
+    /**
+     * @brief Insert leftover customers into truck routes, cheapest insertion first.
+     *
+     * The best insertion of every (customer, truck) pair is kept in a priority queue, keyed by feasibility and
+     * the resulting working time of the truck. Each truck carries an epoch which is bumped whenever one of its
+     * routes changes; a popped entry computed at an older epoch is re-evaluated and pushed back instead of being
+     * applied.
+     */
+    void _insert_leftover(const std::vector<std::size_t> &leftover, std::vector<std::vector<TruckRoute>> &truck_routes)
     {
         auto problem = Problem::get_instance();
+        const auto n = problem->customers.size();
 
-        std::vector<std::size_t> leftover_copy(leftover);
-        std::shuffle(leftover_copy.begin(), leftover_copy.end(), utils::rng);
+        std::vector<double> working_time(problem->trucks_count);
+        std::vector<TruckTimeline> timelines;
+        for (std::size_t truck = 0; truck < problem->trucks_count; truck++)
+        {
+            working_time[truck] = evaluate_truck(truck_routes[truck]).working_time;
+            timelines.emplace_back(truck_routes[truck]);
+        }
 
-        for (auto &customer : leftover_copy)
+        struct _Candidate
         {
-            std::vector<std::vector<TruckRoute>> truck_routes_modified(truck_routes);
-            std::shared_ptr<ST> temp = nullptr;
+            bool feasible;
+            double cost;
+            std::size_t customer, truck, route, epoch;
+            InsertionEntry entry;
 
-            for (std::size_t truck = 0; truck < problem->trucks_count; truck++)
+            bool operator<(const _Candidate &other) const
             {
-                for (std::size_t route = 0; route < truck_routes[truck].size(); route++)
+                // std::priority_queue is a max-heap
+                if (feasible != other.feasible)
                 {
-                    const auto &customers = truck_routes[truck][route].customers();
-                    for (std::size_t i = 1; i < customers.size(); i++)
-                    {
-                        std::vector<std::size_t> r(customers);
-                        r.insert(r.begin() + i, customer);
+                    return other.feasible;
+                }
 
-                        // Temporary modify
-                        truck_routes_modified[truck][route] = TruckRoute(r);
+                return cost > other.cost;
+            }
+        };
 
-                        auto new_temp = std::make_shared<ST>(truck_routes_modified, drone_routes, nullptr, false);
-                        if (temp == nullptr || new_temp->working_time < temp->working_time || (new_temp->feasible && !temp->feasible))
-                        {
-                            temp = new_temp;
-                        }
+        std::vector<std::size_t> epoch(problem->trucks_count);
+        std::vector<bool> inserted_customers(n);
+        std::priority_queue<_Candidate> queue;
 
-                        // Restore
-                        truck_routes_modified[truck][route] = truck_routes[truck][route];
-                    }
-                }
-
-                // Temporary append
-                truck_routes_modified[truck].emplace_back(std::vector<std::size_t>{0, customer, 0});
+        const auto push = [&truck_routes, &working_time, &timelines, &epoch, &queue](const std::size_t &customer, const std::size_t &truck)
+        {
+            const auto &routes = truck_routes[truck];
 
-                auto new_temp = std::make_shared<ST>(truck_routes_modified, drone_routes, nullptr, false);
-                if (temp == nullptr || new_temp->working_time < temp->working_time || (new_temp->feasible && !temp->feasible))
+            std::size_t best_route = routes.size();
+            auto best = best_truck_insertion(routes, timelines[truck], routes.size(), customer, working_time[truck]);
+            for (std::size_t route = 0; route < routes.size(); route++)
+            {
+                auto entry = best_truck_insertion(routes, timelines[truck], route, customer, working_time[truck]);
+                if ((entry.feasible && !best.feasible) || (entry.feasible == best.feasible && entry.delta < best.delta))
                 {
-                    temp = new_temp;
+                    best = entry;
+                    best_route = route;
                 }
+            }
 
-                // Restore
-                truck_routes_modified[truck].pop_back();
+            queue.push({best.feasible, working_time[truck] + best.delta, customer, truck, best_route, epoch[truck], best});
+        };
+
+        for (auto &customer : leftover)
+        {
+            for (std::size_t truck = 0; truck < problem->trucks_count; truck++)
+            {
+                push(customer, truck);
+            }
+        }
+
+        while (!queue.empty())
+        {
+            auto candidate = queue.top();
+            queue.pop();
+
+            if (inserted_customers[candidate.customer])
+            {
+                continue;
             }
 
-            truck_routes = temp->truck_routes;
+            if (candidate.epoch != epoch[candidate.truck])
+            {
+                push(candidate.customer, candidate.truck);
+                continue;
+            }
+
+            auto &routes = truck_routes[candidate.truck];
+            if (candidate.route == routes.size())
+            {
+                routes.emplace_back(std::vector<std::size_t>{0, candidate.customer, 0});
+            }
+            else
+            {
+                routes[candidate.route] = TruckRoute(inserted(routes[candidate.route].customers(), candidate.entry.position, candidate.customer));
+            }
+
+            inserted_customers[candidate.customer] = true;
+            working_time[candidate.truck] = candidate.cost;
+            timelines[candidate.truck] = TruckTimeline(routes);
+            epoch[candidate.truck]++;
         }
     }
 
+    /**
+     * @brief Partition customers into `k` clusters with k-means++.
+     *
+     * @param weights The optional workload of each customer, used to balance the total workload among clusters
+     */
     std::vector<std::vector<std::size_t>> clusterize_1(
         const std::vector<std::size_t> &customers,
-        const std::size_t &k)
+        const std::size_t &k,
+        const std::vector<double> &weights = {})
     {
         std::vector<std::vector<std::size_t>> clusters(k);
         if (customers.empty())
@@ -120,38 +189,17 @@ namespace d2d
 
         auto problem = Problem::get_instance();
 
-        alglib::clusterizerstate state;
-        alglib::clusterizercreate(state);
-
-        alglib::real_2d_array matrix;
-        std::vector<double> xy;
-        xy.reserve(2 * customers.size());
-        for (auto &index : customers)
+        std::vector<double> x(customers.size()), y(customers.size());
+        for (std::size_t i = 0; i < customers.size(); i++)
         {
-            xy.push_back(problem->customers[index].x);
-            xy.push_back(problem->customers[index].y);
+            x[i] = problem->customers[customers[i]].x;
+            y[i] = problem->customers[customers[i]].y;
         }
-        matrix.setcontent(customers.size(), 2, xy.data());
-
-        alglib::clusterizersetpoints(state, matrix, 2);
-        alglib::clusterizersetkmeanslimits(state, 1, 500);
-
-        alglib::kmeansreport report;
-        alglib::clusterizerrunkmeans(state, k, report);
 
-        if (report.terminationtype == 1)
-        {
-            for (std::size_t i = 0; i < customers.size(); i++)
-            {
-                clusters[report.cidx[i]].push_back(customers[i]);
-            }
-        }
-        else
+        auto assignment = utils::kmeans(x, y, k, weights);
+        for (std::size_t i = 0; i < customers.size(); i++)
         {
-            for (std::size_t i = 0; i < customers.size(); i++)
-            {
-                clusters[i % k].push_back(customers[i]);
-            }
+            clusters[assignment[i]].push_back(customers[i]);
         }
 
         return clusters;
@@ -296,7 +344,26 @@ namespace d2d
         std::vector<std::vector<std::size_t>> clusters;
         if constexpr (_Clusterizer == 1)
         {
-            clusters = clusterize_1(customers, vehicles_count);
+            // Workload of a customer: service time plus a round trip from the depot
+            std::vector<double> weights(customers.size());
+            std::transform(
+                customers.begin(), customers.end(), weights.begin(),
+                [&problem](const std::size_t &customer)
+                {
+                    const auto &distance = problem->distances[0][customer];
+                    if constexpr (std::is_same_v<RT, TruckRoute>)
+                    {
+                        return problem->customers[customer].truck_service_time + 2 * distance / problem->truck->average_speed;
+                    }
+                    else
+                    {
+                        auto drone = problem->drone;
+                        return problem->customers[customer].drone_service_time +
+                               2 * (drone->takeoff_time() + drone->cruise_time(distance) + drone->landing_time());
+                    }
+                });
+
+            clusters = clusterize_1(customers, vehicles_count, weights);
         }
         else
         {
@@ -323,8 +390,33 @@ namespace d2d
                 });
         };
 
+        // Spatial index over unassigned customers, used to find the cluster nearest to the last assigned customer
+        std::vector<double> x(problem->customers.size()), y(problem->customers.size());
+        for (std::size_t i = 0; i < problem->customers.size(); i++)
+        {
+            x[i] = problem->customers[i].x;
+            y[i] = problem->customers[i].y;
+        }
+
+        utils::GridIndex unassigned(customers, x, y);
+        std::vector<std::size_t> cluster_of(problem->customers.size());
+        for (std::size_t i = 0; i < clusters.size(); i++)
+        {
+            for (auto &customer : clusters[i])
+            {
+                cluster_of[customer] = i;
+            }
+        }
+
         select_vehicle();
-        std::size_t cluster_i = 0, last_customer = std::size_t(-1);
+        std::size_t cluster_i = 0, last_customer = 0;
+
+        const auto assign_back = [&clusters, &cluster_i, &last_customer, &unassigned]()
+        {
+            last_customer = clusters[cluster_i].back();
+            clusters[cluster_i].pop_back();
+            unassigned.remove(last_customer);
+        };
 
         while (std::any_of(clusters.begin(), clusters.end(), [](const std::vector<std::size_t> &c)
                            { return !c.empty(); }))
@@ -332,15 +424,7 @@ namespace d2d
             // Loop invariant: clusters[cluster_i] may be empty, inserting to vehicle route may yield infeasible route
             if (clusters[cluster_i].empty())
             {
-                std::vector<double> distances(clusters.size(), std::numeric_limits<double>::max());
-                for (std::size_t i = 0; i < clusters.size(); i++)
-                {
-                    for (auto &customer : clusters[i])
-                    {
-                        distances[i] = std::min(distances[i], problem->distances[last_customer][customer]);
-                    }
-                }
-                cluster_i = std::min_element(distances.begin(), distances.end()) - distances.begin();
+                cluster_i = cluster_of[*unassigned.nearest(x[last_customer], y[last_customer])];
 
                 _sort_cluster_with_starting_point(clusters[cluster_i], last_customer);
                 continue;
@@ -360,8 +444,7 @@ namespace d2d
                     {
                         if (_try_insert<ST>(vehicle_routes[vehicle[i]], clusters[cluster_i].back(), truck_routes, drone_routes))
                         {
-                            last_customer = clusters[cluster_i].back();
-                            clusters[cluster_i].pop_back();
+                            assign_back();
                             new_route = false;
 
                             std::rotate(vehicle.begin(), vehicle.begin() + i, vehicle.end());
@@ -382,8 +465,7 @@ namespace d2d
                                 {
                                     cluster_i = i;
 
-                                    last_customer = clusters[cluster_i].back();
-                                    clusters[cluster_i].pop_back();
+                                    assign_back();
                                     new_route = false;
 
                                     inserted = true;
@@ -400,8 +482,7 @@ namespace d2d
                 }
                 else
                 {
-                    last_customer = clusters[cluster_i].back();
-                    clusters[cluster_i].pop_back();
+                    assign_back();
                     new_route = false;
                 }
             }
@@ -414,8 +495,7 @@ namespace d2d
                 }
                 else
                 {
-                    last_customer = clusters[cluster_i].back();
-                    clusters[cluster_i].pop_back();
+                    assign_back();
                 }
             }
         }
@@ -431,7 +511,7 @@ namespace d2d
         return vehicle_routes;
     }
 
-    template <typename ST, int _Clusterizer>
+    template <typename ST, int _Clusterizer, std::enable_if_t<_Clusterizer == 1 || _Clusterizer == 2, bool> = true>
     std::shared_ptr<ST> initial_impl()
     {
         auto problem = Problem::get_instance();
@@ -439,7 +519,7 @@ namespace d2d
         std::vector<std::size_t> dronable, truck_only;
         for (std::size_t i = 1; i < problem->customers.size(); i++)
         {
-            if (problem->customers[i].dronable)
+            if (problem->drone_serviceable[i])
             {
                 dronable.push_back(i);
             }
@@ -454,7 +534,241 @@ namespace d2d
         std::vector<std::size_t> leftover;
         std::vector<std::vector<TruckRoute>> truck_routes = _initial_helper<ST, _Clusterizer, TruckRoute>(truck_only, &leftover);
 
-        _insert_leftover<ST>(leftover, truck_routes, drone_routes);
+        _insert_leftover(leftover, truck_routes);
         return std::make_shared<ST>(truck_routes, drone_routes, std::make_shared<ParentInfo<ST>>(nullptr, utils::format("initial-%d", _Clusterizer)));
     }
+
+    /**
+     * @brief Regret-k insertion construction.
+     *
+     * A customer x route matrix stores the exact best feasible insertion of every unassigned customer into every route
+     * (plus a "new route" slot per vehicle). At each step, the customer with the largest regret (difference
+     * between its best and its next `K - 1` best insertions) is inserted at its best position, after which only
+     * the rows of the modified vehicle are recomputed: a single row for drones (whose routes are independent)
+     * and all rows of the vehicle for trucks (whose speed depends on the time of day).
+     */
+    template <typename ST, int _Variant, std::enable_if_t<_Variant == 3, bool> = true, std::size_t K = 3>
+    std::shared_ptr<ST> initial_impl()
+    {
+        auto problem = Problem::get_instance();
+        const auto vehicles_count = problem->trucks_count + problem->drones_count;
+
+        std::vector<std::vector<TruckRoute>> truck_routes(problem->trucks_count);
+        std::vector<std::vector<DroneRoute>> drone_routes(problem->drones_count);
+        std::vector<double> working_time(vehicles_count);
+
+        std::vector<std::size_t> unassigned(problem->customers.size() - 1);
+        std::iota(unassigned.begin(), unassigned.end(), 1);
+
+        // matrix[vehicle][route][customer], the last row of each vehicle is the "new route" slot
+        std::vector<std::vector<std::vector<InsertionEntry>>> matrix(
+            vehicles_count,
+            std::vector<std::vector<InsertionEntry>>(1, std::vector<InsertionEntry>(problem->customers.size(), InsertionEntry::infeasible())));
+
+        std::vector<TruckTimeline> timelines(problem->trucks_count, TruckTimeline({}));
+        const auto truck_entry = [&problem, &truck_routes, &working_time, &timelines](const std::size_t &truck, const std::size_t &route, const std::size_t &customer)
+        {
+            const auto &routes = truck_routes[truck];
+            if (route < routes.size() && routes[route].weight() + problem->customers[customer].demand > problem->truck->capacity)
+            {
+                return InsertionEntry::infeasible();
+            }
+
+            // Regrets compare exact insertion costs, so every position is evaluated and infeasible rankings are dropped
+            auto entry = best_truck_insertion(routes, timelines[truck], route, customer, working_time[truck]);
+            return entry.feasible ? entry : InsertionEntry::infeasible();
+        };
+
+        const auto drone_entry = [&problem, &drone_routes](const std::size_t &drone, const std::size_t &route, const std::size_t &customer)
+        {
+            const auto &routes = drone_routes[drone];
+            if (!problem->drone_serviceable[customer])
+            {
+                return InsertionEntry::infeasible();
+            }
+
+            if (route == routes.size())
+            {
+                DroneRoute new_route(std::vector<std::size_t>{0, customer, 0});
+                return drone_route_feasible(new_route) ? InsertionEntry{new_route.working_time(), 1, true} : InsertionEntry::infeasible();
+            }
+
+            const auto &customers = routes[route].customers();
+            if (routes[route].weight() + problem->customers[customer].demand > problem->drone->capacity ||
+                std::any_of(
+                    customers.begin() + 1, customers.end() - 1,
+                    [&problem, &customer](const std::size_t &c)
+                    { return !problem->drone_compatible[customer][c]; }))
+            {
+                return InsertionEntry::infeasible();
+            }
+
+            // The increase in working time and the waiting times are exact in O(1) per position, so only the
+            // cheapest positions satisfying waiting times are constructed to check the remaining constraints
+            const auto &slack = routes[route].waiting_time_slack();
+            std::vector<std::pair<double, std::size_t>> positions;
+            for (std::size_t position = 1; position < customers.size(); position++)
+            {
+                const double to = DroneRoute::time_segment_between(customer, customers[position]),
+                             delay = DroneRoute::time_segment_between(customers[position - 1], customer) + to -
+                                     DroneRoute::time_segment_between(customers[position - 1], customers[position]),
+                             waiting_time = to + slack.return_time(position) - problem->customers[customer].drone_service_time;
+                if (slack.insertion_feasible(position, delay, waiting_time))
+                {
+                    positions.emplace_back(delay, position);
+                }
+            }
+
+            std::sort(positions.begin(), positions.end());
+            for (auto &[_, position] : positions)
+            {
+                DroneRoute new_route(inserted(customers, position, customer));
+                if (drone_route_feasible(new_route))
+                {
+                    return InsertionEntry{new_route.working_time() - routes[route].working_time(), position, true};
+                }
+            }
+
+            return InsertionEntry::infeasible();
+        };
+
+        const auto update_row = [&problem, &matrix, &unassigned, &truck_entry, &drone_entry](const std::size_t &vehicle, const std::size_t &route)
+        {
+            auto &row = matrix[vehicle][route];
+            for (auto &customer : unassigned)
+            {
+                row[customer] = vehicle < problem->trucks_count
+                                    ? truck_entry(vehicle, route, customer)
+                                    : drone_entry(vehicle - problem->trucks_count, route, customer);
+            }
+        };
+
+        for (std::size_t vehicle = 0; vehicle < vehicles_count; vehicle++)
+        {
+            update_row(vehicle, 0);
+        }
+
+        struct _Option
+        {
+            double cost;
+            std::size_t vehicle, route;
+        };
+
+        while (!unassigned.empty())
+        {
+            std::size_t selected = unassigned.size(), selected_options = 0;
+            double selected_regret = 0;
+            _Option selected_best{0, 0, 0};
+
+            for (std::size_t index = 0; index < unassigned.size(); index++)
+            {
+                const auto customer = unassigned[index];
+
+                // The K cheapest options of this customer, sorted by cost
+                std::array<_Option, K> best;
+                std::size_t options = 0;
+                for (std::size_t vehicle = 0; vehicle < vehicles_count; vehicle++)
+                {
+                    for (std::size_t route = 0; route < matrix[vehicle].size(); route++)
+                    {
+                        const auto &entry = matrix[vehicle][route][customer];
+                        if (!entry.feasible)
+                        {
+                            continue;
+                        }
+
+                        _Option option{working_time[vehicle] + entry.delta, vehicle, route};
+                        if (options < K)
+                        {
+                            best[options++] = option;
+                        }
+                        else if (option.cost < best[K - 1].cost)
+                        {
+                            best[K - 1] = option;
+                        }
+                        else
+                        {
+                            continue;
+                        }
+
+                        for (std::size_t i = options - 1; i > 0 && best[i].cost < best[i - 1].cost; i--)
+                        {
+                            std::swap(best[i], best[i - 1]);
+                        }
+                    }
+                }
+
+                if (options == 0)
+                {
+                    continue;
+                }
+
+                double regret = 0;
+                for (std::size_t i = 1; i < options; i++)
+                {
+                    regret += best[i].cost - best[0].cost;
+                }
+
+                // Customers with fewer than K options are the most urgent ones
+                if (selected == unassigned.size() ||
+                    options < selected_options ||
+                    (options == selected_options && (regret > selected_regret || (regret == selected_regret && best[0].cost < selected_best.cost))))
+                {
+                    selected = index;
+                    selected_options = options;
+                    selected_regret = regret;
+                    selected_best = best[0];
+                }
+            }
+
+            if (selected == unassigned.size())
+            {
+                break; // No customer can be inserted feasibly anymore
+            }
+
+            const auto customer = unassigned[selected];
+            std::swap(unassigned[selected], unassigned.back());
+            unassigned.pop_back();
+
+            const auto [_, vehicle, route] = selected_best;
+            const auto entry = matrix[vehicle][route][customer];
+            working_time[vehicle] += entry.delta;
+
+            const auto insert = [&customer, &entry, &route]<typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>(std::vector<RT> &routes)
+            {
+                if (route == routes.size())
+                {
+                    routes.emplace_back(std::vector<std::size_t>{0, customer, 0});
+                }
+                else
+                {
+                    routes[route] = RT(inserted(routes[route].customers(), entry.position, customer));
+                }
+            };
+
+            if (route + 1 == matrix[vehicle].size())
+            {
+                // Keep the "new route" slot as the last row
+                matrix[vehicle].insert(matrix[vehicle].end() - 1, std::vector<InsertionEntry>(problem->customers.size(), InsertionEntry::infeasible()));
+            }
+
+            if (vehicle < problem->trucks_count)
+            {
+                insert(truck_routes[vehicle]);
+                timelines[vehicle] = TruckTimeline(truck_routes[vehicle]);
+                for (std::size_t r = 0; r < matrix[vehicle].size(); r++)
+                {
+                    update_row(vehicle, r);
+                }
+            }
+            else
+            {
+                insert(drone_routes[vehicle - problem->trucks_count]);
+                update_row(vehicle, route);
+            }
+        }
+
+        _insert_leftover(unassigned, truck_routes);
+        return std::make_shared<ST>(truck_routes, drone_routes, std::make_shared<ParentInfo<ST>>(nullptr, "initial-3"));
+    }
 }
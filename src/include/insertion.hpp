@@ -0,0 +1,267 @@
+#pragma once
+
+#include "routes.hpp"
+
+namespace d2d
+{
+    /** @brief Working time and feasibility of a single vehicle, without constructing a whole solution. */
+    struct VehicleEvaluation
+    {
+        double working_time;
+        bool feasible;
+    };
+
+    /** @brief A candidate insertion of a customer into a route, stored in an insertion-cost matrix. */
+    struct InsertionEntry
+    {
+        /** @brief Increase in working time of the vehicle owning the route. */
+        double delta;
+
+        /** @brief Index in the route's customer list where the customer is inserted. */
+        std::size_t position;
+
+        bool feasible;
+
+        static InsertionEntry infeasible()
+        {
+            return {std::numeric_limits<double>::max(), 0, false};
+        }
+    };
+
+    /**
+     * @brief Insert `customer` into `customers` before index `position`.
+     */
+    template <typename _Container>
+    std::vector<std::size_t> inserted(const _Container &customers, const std::size_t &position, const std::size_t &customer)
+    {
+        std::vector<std::size_t> result;
+        result.reserve(customers.size() + 1);
+        result.insert(result.end(), customers.begin(), customers.begin() + position);
+        result.push_back(customer);
+        result.insert(result.end(), customers.begin() + position, customers.end());
+        return result;
+    }
+
+    /** @brief Additional traveling distance of inserting `customer` into `customers` before index `position`. */
+    template <typename _Container>
+    double insertion_distance(const _Container &customers, const std::size_t &position, const std::size_t &customer)
+    {
+        auto problem = Problem::get_instance();
+        const std::size_t prev = customers[position - 1], next = customers[position];
+        return problem->distances[prev][customer] + problem->distances[customer][next] - problem->distances[prev][next];
+    }
+
+    /** @brief Whether a single drone route satisfies all constraints. */
+    bool drone_route_feasible(const DroneRoute &route)
+    {
+        return utils::approximate(route.capacity_violation(), 0.0) &&
+               utils::approximate(route.energy_violation(), 0.0) &&
+               utils::approximate(route.fixed_time_violation(), 0.0) &&
+               utils::approximate(route.waiting_time_violation(), 0.0);
+    }
+
+    /**
+     * @brief Evaluate a truck whose route at `index` is replaced by `customers`.
+     *
+     * If `index == routes.size()`, `customers` is appended as a new route instead. If `index > routes.size()`,
+     * the truck is evaluated unchanged. Because truck speed depends on the time of day, all routes after `index`
+     * are re-evaluated as well.
+     */
+    VehicleEvaluation evaluate_truck(
+        const std::vector<TruckRoute> &routes,
+        const std::size_t &index,
+        const std::vector<std::size_t> &customers)
+    {
+        auto problem = Problem::get_instance();
+
+        const auto weight = [&problem](const std::vector<std::size_t> &route_customers)
+        {
+            double result = 0;
+            for (auto &customer : route_customers)
+            {
+                result += problem->customers[customer].demand;
+            }
+
+            return result;
+        };
+
+        std::size_t coefficients_index = 0;
+        double current_within_timespan = 0, working_time = 0, violation = 0;
+        const auto evaluate = [&](const auto &route_customers, const double &route_weight)
+        {
+            working_time += TruckRoute::calculate_working_time(route_customers, coefficients_index, current_within_timespan, violation);
+            violation += std::max(0.0, route_weight - problem->truck->capacity);
+        };
+
+        for (std::size_t i = 0; i < routes.size(); i++)
+        {
+            if (i == index)
+            {
+                evaluate(customers, weight(customers));
+            }
+            else
+            {
+                evaluate(routes[i].customers(), routes[i].weight());
+            }
+        }
+
+        if (index == routes.size())
+        {
+            evaluate(customers, weight(customers));
+        }
+
+        return {working_time, utils::approximate(violation, 0.0)};
+    }
+
+    /** @brief Evaluate a truck with its current routes. */
+    VehicleEvaluation evaluate_truck(const std::vector<TruckRoute> &routes)
+    {
+        return evaluate_truck(routes, routes.size() + 1, {});
+    }
+
+    /**
+     * @brief The routes of a truck timed at their actual departure times. Built once whenever the routes change, it
+     * screens insertions into them in O(1) per position.
+     */
+    struct TruckTimeline
+    {
+        /** @brief The waiting time slack of each route at its departure time */
+        std::vector<WaitingTimeSlack> slacks;
+
+        /**
+         * @brief For each route, a lower bound of the time from serving the customer at each position until returning
+         * to the depot, driving at the fastest speed whatever the departure time.
+         */
+        std::vector<std::vector<double>> return_bounds;
+
+        explicit TruckTimeline(const std::vector<TruckRoute> &routes)
+        {
+            auto problem = Problem::get_instance();
+
+            std::size_t coefficients_index = 0;
+            double current_within_timespan = 0;
+            for (auto &route : routes)
+            {
+                const auto &customers = route.customers();
+                slacks.push_back(TruckRoute::waiting_time_slack(customers, coefficients_index, current_within_timespan));
+
+                auto &bound = return_bounds.emplace_back(customers.size());
+                for (std::size_t i = customers.size() - 1; i > 1; i--)
+                {
+                    bound[i - 1] = bound[i] +
+                                   problem->distances[customers[i - 1]][customers[i]] / problem->truck->maximum_speed +
+                                   problem->customers[customers[i - 1]].truck_service_time;
+                }
+            }
+        }
+
+        /**
+         * @brief Whether inserting `customer` before `position` of route `route` may keep waiting times within the
+         * limit. Waiting times before the insertion point can only grow, and the inserted customer waits at least as
+         * long as driving the rest of the route at the fastest speed.
+         */
+        bool insertion_feasible(
+            const RouteCustomers &customers,
+            const std::size_t &route,
+            const std::size_t &position,
+            const std::size_t &customer) const
+        {
+            auto problem = Problem::get_instance();
+            const double waiting_time = problem->distances[customer][customers[position]] / problem->truck->maximum_speed +
+                                        return_bounds[route][position];
+            return slacks[route].insertion_feasible(position, 0.0, waiting_time);
+        }
+    };
+
+    /**
+     * @brief Find the best position to insert `customer` into route `route` of a truck.
+     *
+     * Every position which `timeline` does not prove to violate waiting times is evaluated exactly, and the feasible
+     * one with the smallest increase in working time is returned. If `route == routes.size()`, the customer is served
+     * by a new route. If there is no feasible position, the evaluated candidate with the smallest working time is
+     * returned with `feasible = false`, together with the position closest by distance among those ruled out. If the
+     * customer would exceed the truck capacity of the route, only the latter is evaluated.
+     *
+     * @param timeline The timeline of `routes`
+     * @param working_time The current working time of the truck
+     * @param attempts If smaller than the number of positions, only the `attempts` positions adding the least
+     * traveling distance are considered. This is faster but may miss the best or the only feasible position, since
+     * distance is only a proxy of working time under time-dependent speeds.
+     */
+    InsertionEntry best_truck_insertion(
+        const std::vector<TruckRoute> &routes,
+        const TruckTimeline &timeline,
+        const std::size_t &route,
+        const std::size_t &customer,
+        const double &working_time,
+        const std::size_t &attempts = std::numeric_limits<std::size_t>::max())
+    {
+        auto problem = Problem::get_instance();
+        if (route == routes.size())
+        {
+            auto evaluation = evaluate_truck(routes, route, {0, customer, 0});
+            return {evaluation.working_time - working_time, 1, evaluation.feasible};
+        }
+
+        const auto &customers = routes[route].customers();
+        const auto closer = [&customers, &customer](const std::size_t &i, const std::size_t &j)
+        {
+            return insertion_distance(customers, i, customer) < insertion_distance(customers, j, customer);
+        };
+
+        std::vector<std::size_t> positions(customers.size() - 1);
+        std::iota(positions.begin(), positions.end(), 1);
+
+        const auto limit = std::min(attempts, positions.size());
+        if (limit < positions.size())
+        {
+            std::partial_sort(positions.begin(), positions.begin() + limit, positions.end(), closer);
+            positions.resize(limit);
+        }
+
+        auto best = InsertionEntry::infeasible(), fallback = InsertionEntry::infeasible();
+        const auto evaluate = [&](const std::size_t &position)
+        {
+            auto evaluation = evaluate_truck(routes, route, inserted(customers, position, customer));
+            InsertionEntry entry{evaluation.working_time - working_time, position, evaluation.feasible};
+            auto &target = entry.feasible ? best : fallback;
+            if (entry.delta < target.delta)
+            {
+                target = entry;
+            }
+        };
+
+        if (routes[route].weight() + problem->customers[customer].demand > problem->truck->capacity)
+        {
+            const auto position = *std::min_element(positions.begin(), positions.end(), closer);
+            auto evaluation = evaluate_truck(routes, route, inserted(customers, position, customer));
+            return {evaluation.working_time - working_time, position, false};
+        }
+
+        // The closest position ruled out by the timeline, 0 if there is none
+        std::size_t ruled_out = 0;
+        for (auto &position : positions)
+        {
+            if (timeline.insertion_feasible(customers, route, position, customer))
+            {
+                evaluate(position);
+            }
+            else if (ruled_out == 0 || closer(position, ruled_out))
+            {
+                ruled_out = position;
+            }
+        }
+
+        if (best.feasible)
+        {
+            return best;
+        }
+
+        if (ruled_out != 0)
+        {
+            evaluate(ruled_out);
+        }
+
+        return fallback;
+    }
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "random.hpp"
+
+namespace utils
+{
+    /**
+     * @brief Squared distances from every point to a center.
+     *
+     * Coordinates are stored as separate contiguous arrays so that this loop is vectorized by the compiler.
+     */
+    void __squared_distances(
+        const std::vector<double> &x,
+        const std::vector<double> &y,
+        const double &cx,
+        const double &cy,
+        double *output)
+    {
+        const std::size_t n = x.size();
+        const double *px = x.data(), *py = y.data();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            const double dx = px[i] - cx, dy = py[i] - cy;
+            output[i] = dx * dx + dy * dy;
+        }
+    }
+
+    /**
+     * @brief Partition 2D points into `k` clusters with k-means++ seeding and Lloyd iterations.
+     *
+     * If `weights` is non-empty, the assignment step is balanced: points are assigned in decreasing order of
+     * the gap between their nearest and second nearest centers, each to the nearest center whose total weight
+     * stays within `(1 + slack) * sum(weights) / k`. Iterations stop early when no assignment changes or when
+     * no center moves further than `tolerance`.
+     *
+     * @param x The x-coordinates of the points
+     * @param y The y-coordinates of the points
+     * @param k The number of clusters
+     * @param weights The optional weights of the points for balancing
+     * @param slack The allowed relative excess over the average cluster weight
+     * @param max_iterations The maximum number of Lloyd iterations
+     * @param tolerance The minimum center movement to keep iterating
+     * @return The cluster index of each point
+     */
+    std::vector<std::size_t> kmeans(
+        const std::vector<double> &x,
+        const std::vector<double> &y,
+        const std::size_t &k,
+        const std::vector<double> &weights = {},
+        const double &slack = 0.1,
+        const std::size_t &max_iterations = 500,
+        const double &tolerance = 1e-6)
+    {
+        const std::size_t n = x.size();
+        if (k == 0)
+        {
+            throw std::invalid_argument("Cannot partition points into 0 clusters");
+        }
+
+        std::vector<std::size_t> assignment(n);
+        if (n <= k)
+        {
+            std::iota(assignment.begin(), assignment.end(), 0);
+            return assignment;
+        }
+
+        // distances[c * n + i] is the squared distance from point i to center c
+        std::vector<double> cx(k), cy(k), distances(k * n);
+
+        /* k-means++ seeding */
+        {
+            std::vector<double> nearest(n, std::numeric_limits<double>::max());
+            std::size_t first = random<std::size_t>(0, n - 1);
+            cx[0] = x[first];
+            cy[0] = y[first];
+
+            for (std::size_t c = 1; c < k; c++)
+            {
+                __squared_distances(x, y, cx[c - 1], cy[c - 1], distances.data());
+
+                double sum = 0;
+                for (std::size_t i = 0; i < n; i++)
+                {
+                    nearest[i] = std::min(nearest[i], distances[i]);
+                    sum += nearest[i];
+                }
+
+                std::size_t chosen = n - 1;
+                double value = random(0.0, sum);
+                for (std::size_t i = 0; i < n; i++)
+                {
+                    value -= nearest[i];
+                    if (value <= 0)
+                    {
+                        chosen = i;
+                        break;
+                    }
+                }
+
+                cx[c] = x[chosen];
+                cy[c] = y[chosen];
+            }
+        }
+
+        double capacity = std::numeric_limits<double>::max();
+        if (!weights.empty())
+        {
+            capacity = std::max(
+                (1.0 + slack) * std::accumulate(weights.begin(), weights.end(), 0.0) / k,
+                *std::max_element(weights.begin(), weights.end()));
+        }
+
+        std::vector<std::size_t> order(n), centers(k);
+        std::vector<double> load(k);
+        for (std::size_t iteration = 0; iteration < max_iterations; iteration++)
+        {
+            for (std::size_t c = 0; c < k; c++)
+            {
+                __squared_distances(x, y, cx[c], cy[c], distances.data() + c * n);
+            }
+
+            std::vector<std::size_t> new_assignment(n);
+            if (weights.empty())
+            {
+                for (std::size_t i = 0; i < n; i++)
+                {
+                    std::size_t best = 0;
+                    for (std::size_t c = 1; c < k; c++)
+                    {
+                        if (distances[c * n + i] < distances[best * n + i])
+                        {
+                            best = c;
+                        }
+                    }
+
+                    new_assignment[i] = best;
+                }
+            }
+            else
+            {
+                std::vector<double> gap(n);
+                for (std::size_t i = 0; i < n; i++)
+                {
+                    double first = std::numeric_limits<double>::max(), second = first;
+                    for (std::size_t c = 0; c < k; c++)
+                    {
+                        const double d = distances[c * n + i];
+                        if (d < first)
+                        {
+                            second = first;
+                            first = d;
+                        }
+                        else if (d < second)
+                        {
+                            second = d;
+                        }
+                    }
+
+                    gap[i] = std::sqrt(second) - std::sqrt(first);
+                }
+
+                std::iota(order.begin(), order.end(), 0);
+                std::sort(
+                    order.begin(), order.end(),
+                    [&gap](const std::size_t &i, const std::size_t &j)
+                    {
+                        return gap[i] > gap[j];
+                    });
+
+                std::fill(load.begin(), load.end(), 0.0);
+                for (auto &i : order)
+                {
+                    std::iota(centers.begin(), centers.end(), 0);
+                    std::sort(
+                        centers.begin(), centers.end(),
+                        [&distances, &n, &i](const std::size_t &c1, const std::size_t &c2)
+                        {
+                            return distances[c1 * n + i] < distances[c2 * n + i];
+                        });
+
+                    // Fall back to the nearest center if no center has enough room left
+                    std::size_t best = centers[0];
+                    for (auto &c : centers)
+                    {
+                        if (load[c] + weights[i] <= capacity)
+                        {
+                            best = c;
+                            break;
+                        }
+                    }
+
+                    new_assignment[i] = best;
+                    load[best] += weights[i];
+                }
+            }
+
+            bool changed = iteration == 0 || new_assignment != assignment;
+            assignment.swap(new_assignment);
+            if (!changed)
+            {
+                break;
+            }
+
+            /* Move centers to the means of their clusters */
+            std::vector<double> sx(k), sy(k);
+            std::vector<std::size_t> count(k);
+            for (std::size_t i = 0; i < n; i++)
+            {
+                sx[assignment[i]] += x[i];
+                sy[assignment[i]] += y[i];
+                count[assignment[i]]++;
+            }
+
+            double shift = 0;
+            for (std::size_t c = 0; c < k; c++)
+            {
+                double nx, ny;
+                if (count[c] == 0)
+                {
+                    // Re-seed an empty cluster at the point farthest from its own center
+                    std::size_t farthest = 0;
+                    for (std::size_t i = 1; i < n; i++)
+                    {
+                        if (distances[assignment[i] * n + i] > distances[assignment[farthest] * n + farthest])
+                        {
+                            farthest = i;
+                        }
+                    }
+
+                    nx = x[farthest];
+                    ny = y[farthest];
+                    distances[assignment[farthest] * n + farthest] = 0;
+                }
+                else
+                {
+                    nx = sx[c] / count[c];
+                    ny = sy[c] / count[c];
+                }
+
+                shift = std::max(shift, pow2(nx - cx[c]) + pow2(ny - cy[c]));
+                cx[c] = nx;
+                cy[c] = ny;
+            }
+
+            if (shift < pow2(tolerance))
+            {
+                break;
+            }
+        }
+
+        return assignment;
+    }
+}
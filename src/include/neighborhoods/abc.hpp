@@ -1,8 +1,11 @@
 #pragma once
 
+#include "../arena.hpp"
+#include "../pool.hpp"
 #include "../parent.hpp"
 #include "../problem.hpp"
 #include "../routes.hpp"
+#include "scratch.hpp"
 
 namespace d2d
 {
@@ -12,15 +15,209 @@ namespace d2d
     template <typename ST>
     class BaseNeighborhood
     {
-    public:
-        virtual std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
-            const std::shared_ptr<ST> solution,
-            const std::function<bool(std::shared_ptr<ST>)> &aspiration_criteria) = 0;
+    private:
+        struct _Candidate
+        {
+            typename ST::PartialEvaluation evaluation;
 
-        virtual std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
-            const std::shared_ptr<ST> solution,
-            const std::function<bool(std::shared_ptr<ST>)> &aspiration_criteria) = 0;
+            /** @brief Whether `evaluation` is exact rather than a lower bound */
+            bool exact;
+        };
+
+        struct _Look
+        {
+            std::size_t epoch_i = 0, epoch_j = 0;
+
+            /** @brief Evaluation of the modified vehicles of each candidate of the scan, in enumeration order */
+            std::vector<_Candidate> candidates;
+
+            /** @brief Lowest working time of the modified vehicles over all candidates of the scan */
+            double working_time = 0;
+        };
+
+        double _aspiration_cutoff = std::numeric_limits<double>::max();
+
+        std::map<std::array<std::size_t, 3>, _Look> _looks;
+
+        /** @brief The scan in progress, or `nullptr` */
+        _Look *_current = nullptr;
+
+        /** @brief Whether the scan in progress replays recorded candidates, and the next one to replay */
+        bool _replaying = false;
+        std::size_t _cursor = 0;
+
+        /** @brief The replayed candidate about to be constructed, if it was only bounded when recorded */
+        _Candidate *_inexact = nullptr;
+
+        /** @brief Maximum working time of the vehicles left unmodified by the scan in progress */
+        double _others_working_time = 0;
+
+        static std::size_t _epoch(const std::shared_ptr<ST> &solution, const std::size_t &vehicle)
+        {
+            auto problem = Problem::get_instance();
+            return vehicle < problem->trucks_count
+                       ? solution->truck_epochs[vehicle]
+                       : solution->drone_epochs[vehicle - problem->trucks_count];
+        }
+
+        static bool _empty(const std::shared_ptr<ST> &solution, const std::size_t &vehicle)
+        {
+            auto problem = Problem::get_instance();
+            return vehicle < problem->trucks_count
+                       ? solution->truck_routes[vehicle].empty()
+                       : solution->drone_routes[vehicle - problem->trucks_count].empty();
+        }
+
+        double _cutoff(const std::shared_ptr<ST> &best) const
+        {
+            return best == nullptr ? std::numeric_limits<double>::max() : std::max(best->cost().value, _aspiration_cutoff);
+        }
+
+    protected:
+        /**
+         * @brief Whether each vehicle of `solution` (trucks first) is empty while an earlier vehicle of the same
+         * type is empty too.
+         *
+         * Vehicles of the same type are identical, so moving customers into such a vehicle yields a solution
+         * symmetric to moving them into the first empty vehicle of its type, which is enumerated earlier and
+         * wins ties.
+         */
+        static std::vector<bool> _redundant_vehicles(const std::shared_ptr<ST> &solution)
+        {
+            auto problem = Problem::get_instance();
+            std::vector<bool> result(problem->trucks_count + problem->drones_count);
+
+            bool truck = false, drone = false;
+            for (std::size_t vehicle = 0; vehicle < result.size(); vehicle++)
+            {
+                if (_empty(solution, vehicle))
+                {
+                    auto &found = vehicle < problem->trucks_count ? truck : drone;
+                    result[vehicle] = found;
+                    found = true;
+                }
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Whether `vehicle_i` or `vehicle_j` of `solution` has no routes, in which case a scan over route
+         * pairs of these vehicles has no candidates.
+         */
+        static bool _no_route_pairs(const std::shared_ptr<ST> &solution, const std::size_t &vehicle_i, const std::size_t &vehicle_j)
+        {
+            return _empty(solution, vehicle_i) || _empty(solution, vehicle_j);
+        }
+
+        /**
+         * @brief Start scanning the candidates of `solution` modifying only vehicles `vehicle_i` and `vehicle_j`
+         * (indices among all vehicles, trucks first), unless they provably can neither improve on `best` nor
+         * satisfy the aspiration criteria.
+         *
+         * Each scan records the evaluation of the modified vehicles of its candidates. If both vehicles kept their
+         * modification epoch since the last scan with the same `key`, the candidates are identical and the scan
+         * replays these evaluations instead: see `_promising`.
+         *
+         * @return `false` if the scan should be skipped, `true` otherwise. In the latter case, `_looked` must be
+         * called after the scan.
+         */
+        bool _look(
+            const std::shared_ptr<ST> &solution,
+            const std::shared_ptr<ST> &best,
+            const std::size_t &key,
+            const std::size_t &vehicle_i,
+            const std::size_t &vehicle_j)
+        {
+            auto &look = _looks[{key, vehicle_i, vehicle_j}];
+            const auto epoch_i = _epoch(solution, vehicle_i), epoch_j = _epoch(solution, vehicle_j);
+            const bool replay = look.epoch_i == epoch_i && look.epoch_j == epoch_j;
+
+            typename ST::PartialEvaluation bound;
+            bound.working_time = replay ? look.working_time : 0;
+
+            const double others = ST::others_working_time(solution, vehicle_i, vehicle_j);
+            if (ST::cost_lower_bound(others, bound) >= _cutoff(best))
+            {
+                return false;
+            }
+
+            if (!replay)
+            {
+                look.epoch_i = epoch_i;
+                look.epoch_j = epoch_j;
+                look.candidates.clear();
+                look.working_time = std::numeric_limits<double>::max();
+            }
+
+            _current = &look;
+            _replaying = replay;
+            _cursor = 0;
+            _others_working_time = others;
+            return true;
+        }
+
+        /**
+         * @brief Whether the next candidate of the scan in progress may improve on `best` or satisfy the aspiration
+         * criteria. This must be called exactly once per candidate passed to `construct`, right before modifying
+         * the scratch routes.
+         *
+         * When replaying a scan, the recorded evaluation of the candidate bounds its cost without building its
+         * routes. Otherwise, candidates are bounded in `construct`.
+         */
+        bool _promising(const std::shared_ptr<ST> &best)
+        {
+            _inexact = nullptr;
+            if (_current == nullptr || !_replaying || _cursor == _current->candidates.size())
+            {
+                return true;
+            }
+
+            auto &candidate = _current->candidates[_cursor++];
+            if (ST::cost_lower_bound(_others_working_time, candidate.evaluation) >= _cutoff(best))
+            {
+                return false;
+            }
+
+            if (!candidate.exact)
+            {
+                _inexact = &candidate;
+            }
 
+            return true;
+        }
+
+        /**
+         * @brief Same as `_promising(best)`, with `bound` a lower bound of the evaluation of the modified vehicles
+         * of the candidate, computed without building its routes.
+         *
+         * A candidate rejected by `bound` while recording a scan is recorded with `bound` instead of its exact
+         * evaluation, which is computed later if a replay cannot reject it.
+         */
+        bool _promising(const std::shared_ptr<ST> &best, const typename ST::PartialEvaluation &bound)
+        {
+            if (_current != nullptr && !_replaying)
+            {
+                if (ST::cost_lower_bound(_others_working_time, bound) >= _cutoff(best))
+                {
+                    _current->candidates.push_back({bound, false});
+                    _current->working_time = std::min(_current->working_time, bound.working_time);
+                    return false;
+                }
+
+                return true;
+            }
+
+            return _promising(best) && (_current != nullptr || ST::cost_lower_bound(0, bound) < _cutoff(best));
+        }
+
+        /** @brief End the scan started by `_look`. */
+        void _looked()
+        {
+            _current = nullptr;
+        }
+
+    public:
         virtual std::string label() const = 0;
 
         virtual std::shared_ptr<ST> construct(
@@ -28,7 +225,63 @@ namespace d2d
             const std::vector<std::vector<TruckRoute>> &truck_routes,
             const std::vector<std::vector<DroneRoute>> &drone_routes) const final
         {
-            return std::make_shared<ST>(truck_routes, drone_routes, parent);
+            return std::allocate_shared<ST>(utils::PoolAllocator<ST>(), truck_routes, drone_routes, parent);
+        }
+
+        /**
+         * @brief Construct the neighbor of `solution` held by `scratch`, unless a lower bound of its cost shows that
+         * it can neither improve on `best` nor satisfy the aspiration criteria.
+         *
+         * @return The constructed solution, or `nullptr` if it was rejected early
+         */
+        virtual std::shared_ptr<ST> construct(
+            const std::shared_ptr<ParentInfo<ST>> parent,
+            const std::shared_ptr<ST> &solution,
+            const ScratchRoutes &scratch,
+            const std::shared_ptr<ST> &best) final
+        {
+            if (_current != nullptr)
+            {
+                if (!_replaying)
+                {
+                    auto evaluation = ST::evaluate_modified(scratch);
+                    _current->candidates.push_back({evaluation, true});
+                    _current->working_time = std::min(_current->working_time, evaluation.working_time);
+                    if (ST::cost_lower_bound(_others_working_time, evaluation) >= _cutoff(best))
+                    {
+                        return nullptr;
+                    }
+                }
+                else if (_inexact != nullptr)
+                {
+                    *_inexact = {ST::evaluate_modified(scratch), true};
+                    if (ST::cost_lower_bound(_others_working_time, _inexact->evaluation) >= _cutoff(best))
+                    {
+                        return nullptr;
+                    }
+                }
+            }
+            else if (best != nullptr)
+            {
+                const double cutoff = _cutoff(best);
+                if (ST::cost_lower_bound(solution, scratch, cutoff) >= cutoff)
+                {
+                    return nullptr;
+                }
+            }
+
+            return std::allocate_shared<ST>(utils::PoolAllocator<ST>(), scratch, *solution, parent);
+        }
+
+        /**
+         * @brief Set the cost that a solution must stay below to satisfy the aspiration criteria of the next search.
+         *
+         * Candidates bounded above both this value and the best candidate so far are rejected without being fully
+         * evaluated.
+         */
+        void set_aspiration_cutoff(const double &cutoff)
+        {
+            _aspiration_cutoff = cutoff;
         }
 
         virtual std::shared_ptr<ParentInfo<ST>> parent_ptr(const std::shared_ptr<ST> solution) const final
@@ -54,6 +307,17 @@ namespace d2d
 
         static const std::vector<std::size_t> _empty_tabu_id;
 
+        template <typename _Container>
+        bool _is_sorted_tabu(const _Container &tabu_id) const
+        {
+            return std::any_of(
+                _tabu_list.begin(), _tabu_list.end(),
+                [&tabu_id](const std::vector<std::size_t> &t)
+                {
+                    return std::equal(t.begin(), t.end(), tabu_id.begin(), tabu_id.end());
+                });
+        }
+
     public:
         const std::vector<std::size_t> &last_tabu() const
         {
@@ -95,14 +359,16 @@ namespace d2d
         template <typename... Args>
         bool is_tabu(const std::size_t &tabu_id, const Args &...tabu_ids) const
         {
-            std::vector<std::size_t> t = {tabu_id, tabu_ids...};
-            return is_tabu(t);
+            std::array<std::size_t, 1 + sizeof...(Args)> t = {tabu_id, static_cast<std::size_t>(tabu_ids)...};
+            std::sort(t.begin(), t.end());
+            return _is_sorted_tabu(t);
         }
 
-        bool is_tabu(std::vector<std::size_t> &tabu_id) const
+        template <typename _Alloc>
+        bool is_tabu(std::vector<std::size_t, _Alloc> &tabu_id) const
         {
             std::sort(tabu_id.begin(), tabu_id.end());
-            return std::find(_tabu_list.begin(), _tabu_list.end(), tabu_id) != _tabu_list.end();
+            return _is_sorted_tabu(tabu_id);
         }
 
         void clear()
@@ -111,19 +377,25 @@ namespace d2d
         }
 
         /**
-         * @brief Perform a local search to find the best solution in the neighborhood.
+         * @brief Perform a local search to find the best solution in a neighborhood.
+         *
+         * The neighborhood is taken by its concrete type, so that its `intra_route` and `inter_route` templates
+         * are instantiated with the aspiration criteria inlined.
          *
+         * @param neighborhood The neighborhood to explore
          * @param solution A shared pointer to the current solution
-         * @param aspiration_criteria The aspiration criteria of tabu search. This function should return `true`
+         * @param aspiration_criteria The aspiration criteria of tabu search. This callable should return `true`
          * if the solution satisfies the aspiration criteria, `false` otherwise
          * @return The best solution found that is not `solution`, or `nullptr` if the neighborhood is empty
          */
-        std::shared_ptr<ST> move(
+        template <typename _Neighborhood, typename _AspirationCriteria>
+        static std::shared_ptr<ST> move(
+            _Neighborhood &neighborhood,
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria)
+            const _AspirationCriteria &aspiration_criteria)
         {
 #ifdef DEBUG
-            utils::PerformanceBenchmark _perf(this->label());
+            utils::PerformanceBenchmark _perf(neighborhood.label());
 #endif
 
             std::shared_ptr<ST> result;
@@ -138,12 +410,12 @@ namespace d2d
                 }
             };
 
-            update(this->intra_route(solution, aspiration_criteria));
-            update(this->inter_route(solution, aspiration_criteria));
+            update(neighborhood.intra_route(solution, aspiration_criteria));
+            update(neighborhood.inter_route(solution, aspiration_criteria));
 
             if (result != nullptr)
             {
-                this->add_to_tabu(tabu);
+                neighborhood.add_to_tabu(tabu);
             }
 
             return result;
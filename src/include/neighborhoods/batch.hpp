@@ -0,0 +1,305 @@
+#pragma once
+
+#include "abc.hpp"
+
+namespace d2d
+{
+    /**
+     * @brief Prefix sums over a route, each entry `k` covering customers `[0, k)` except that service times and
+     * weights leave out the depot.
+     */
+    struct RoutePrefix
+    {
+        /** @brief Traveling distance from the first customer to customer `k`. */
+        std::pmr::vector<double> distance;
+
+        std::pmr::vector<double> weight, truck_service_time, drone_service_time;
+
+        /** @brief The number of customers that cannot be served by drones, see `Problem::drone_serviceable`. */
+        std::pmr::vector<std::uint32_t> non_dronable;
+
+        RoutePrefix(const RouteCustomers &customers, std::pmr::memory_resource *resource)
+            : distance(customers.size(), 0.0, resource),
+              weight(customers.size() + 1, 0.0, resource),
+              truck_service_time(customers.size() + 1, 0.0, resource),
+              drone_service_time(customers.size() + 1, 0.0, resource),
+              non_dronable(customers.size() + 1, 0, resource)
+        {
+            auto problem = Problem::get_instance();
+            for (std::size_t k = 0; k < customers.size(); k++)
+            {
+                if (k > 0)
+                {
+                    distance[k] = distance[k - 1] + problem->distances[customers[k - 1]][customers[k]];
+                }
+
+                const bool depot = customers[k] == 0;
+                const auto &customer = problem->customers[customers[k]];
+                weight[k + 1] = weight[k] + (depot ? 0.0 : customer.demand);
+                truck_service_time[k + 1] = truck_service_time[k] + (depot ? 0.0 : customer.truck_service_time);
+                drone_service_time[k + 1] = drone_service_time[k] + (depot ? 0.0 : customer.drone_service_time);
+                non_dronable[k + 1] = non_dronable[k] + !problem->drone_serviceable[customers[k]];
+            }
+        }
+
+        const std::pmr::vector<double> &service_time(const bool &drone) const
+        {
+            return drone ? drone_service_time : truck_service_time;
+        }
+
+        /** @brief Whether drones can serve all customers `[begin, end)`. */
+        bool dronable(const std::size_t &begin, const std::size_t &end) const
+        {
+            return non_dronable[end] == non_dronable[begin];
+        }
+    };
+
+    /**
+     * @brief Lower bounds of the cost of a batch of candidate moves, each replacing the same 2 routes (the sides
+     * of the batch) with new ones.
+     *
+     * Neighborhoods write each candidate as its index tuple and the attributes of both new routes into
+     * structure-of-arrays buffers, usually gathered from `RoutePrefix` of the original routes. `evaluate` then
+     * bounds the whole batch with straight-line arithmetic over contiguous arrays, which the compiler vectorizes.
+     * As in `CrossExchange`, drone working times are exact, truck working times assume the fastest speed
+     * throughout and capacity violations are exact. Waiting time violations of drone routes are bounded from the
+     * `WaitingTimeSlack` of the replaced routes, other violations are bounded by 0.
+     */
+    template <typename ST>
+    class MoveBatch
+    {
+    private:
+        /** @brief Relative error allowed for the sums computed from prefix sums. */
+        static constexpr double _tolerance = 1e-9;
+
+        bool _same_vehicle;
+
+        /** @brief Working time of the new route of each side per arc and per unit of distance. */
+        std::array<double, 2> _per_arc, _per_distance;
+
+        std::array<double, 2> _capacity;
+
+        /** @brief The replaced drone route of each side, or `nullptr` for trucks */
+        std::array<const DroneRoute *, 2> _drone_route;
+
+        /** @brief Bounds over the other routes of the vehicle of each side. */
+        std::array<double, 2> _base_working_time;
+        double _base_capacity_violation = 0;
+        double _base_waiting_time_violation = 0;
+
+        template <typename RT>
+        void _add_base(const std::vector<RT> &routes, const std::size_t &side, const std::size_t &first, const std::size_t &second)
+        {
+            auto problem = Problem::get_instance();
+            for (std::size_t route = 0; route < routes.size(); route++)
+            {
+                if (route == first || route == second)
+                {
+                    continue;
+                }
+
+                if constexpr (std::is_same_v<RT, DroneRoute>)
+                {
+                    _base_working_time[side] += routes[route].working_time();
+                    _base_waiting_time_violation += routes[route].waiting_time_violation();
+                }
+                else
+                {
+                    const auto &customers = routes[route].customers();
+                    double service_time = 0;
+                    for (std::size_t k = 1; k + 1 < customers.size(); k++)
+                    {
+                        service_time += problem->customers[customers[k]].truck_service_time;
+                    }
+
+                    _base_working_time[side] += routes[route].distance() / problem->truck->maximum_speed + service_time;
+                }
+
+                _base_capacity_violation += routes[route].capacity_violation();
+            }
+        }
+
+    public:
+        /** @brief The attributes of the new route of a side, leaving out the depot. */
+        struct Route
+        {
+            double distance, service_time, weight;
+
+            /** @brief The number of customers, including both depots. */
+            std::size_t size;
+
+            /** @brief The number of leading customers (including the depot) kept in place from the replaced route. */
+            std::size_t kept;
+        };
+
+        std::pmr::vector<std::uint32_t> i, j;
+        std::array<std::pmr::vector<double>, 2> distance, service_time, weight, arcs;
+        std::array<std::pmr::vector<std::uint32_t>, 2> kept;
+
+        /** @brief The bounds of each candidate, filled by `evaluate`. */
+        std::pmr::vector<double> working_time, capacity_violation, waiting_time_violation;
+
+        /**
+         * @brief An empty batch replacing the routes at `route_i` of `vehicle_i` and `route_j` of `vehicle_j`
+         * (indices among all vehicles, trucks first) in `solution`.
+         */
+        MoveBatch(
+            const std::shared_ptr<ST> &solution,
+            const std::size_t &vehicle_i,
+            const std::size_t &route_i,
+            const std::size_t &vehicle_j,
+            const std::size_t &route_j,
+            std::pmr::memory_resource *resource)
+            : _same_vehicle(vehicle_i == vehicle_j),
+              _base_working_time({0, 0}),
+              i(resource),
+              j(resource),
+              distance({std::pmr::vector<double>(resource), std::pmr::vector<double>(resource)}),
+              service_time({std::pmr::vector<double>(resource), std::pmr::vector<double>(resource)}),
+              weight({std::pmr::vector<double>(resource), std::pmr::vector<double>(resource)}),
+              arcs({std::pmr::vector<double>(resource), std::pmr::vector<double>(resource)}),
+              kept({std::pmr::vector<std::uint32_t>(resource), std::pmr::vector<std::uint32_t>(resource)}),
+              working_time(resource),
+              capacity_violation(resource),
+              waiting_time_violation(resource)
+        {
+            auto problem = Problem::get_instance();
+            const std::array<std::size_t, 2> vehicles = {vehicle_i, vehicle_j};
+            const std::array<std::size_t, 2> routes = {route_i, route_j};
+            for (std::size_t side = 0; side < 2; side++)
+            {
+                _drone_route[side] = nullptr;
+                if (vehicles[side] < problem->trucks_count)
+                {
+                    _per_arc[side] = 0;
+                    _per_distance[side] = 1 / problem->truck->maximum_speed;
+                    _capacity[side] = problem->truck->capacity;
+                }
+                else
+                {
+                    // Cruise time is linear in distance for all drone configurations
+                    _per_arc[side] = problem->drone->takeoff_time() + problem->drone->landing_time();
+                    _per_distance[side] = problem->drone->cruise_time(1);
+                    _capacity[side] = problem->drone->capacity;
+                    _drone_route[side] = &solution->drone_routes[vehicles[side] - problem->trucks_count][routes[side]];
+                }
+
+                if (side == 1 && _same_vehicle)
+                {
+                    break;
+                }
+
+                // The routes of the vehicle replaced by the batch
+                const auto first = side == 0 ? route_i : route_j, second = _same_vehicle ? route_j : first;
+                if (vehicles[side] < problem->trucks_count)
+                {
+                    _add_base(solution->truck_routes[vehicles[side]], side, first, second);
+                }
+                else
+                {
+                    _add_base(solution->drone_routes[vehicles[side] - problem->trucks_count], side, first, second);
+                }
+            }
+        }
+
+        /** @brief Add a candidate replacing the routes with `new_i` and `new_j`. */
+        void push(const std::size_t &index_i, const std::size_t &index_j, const Route &new_i, const Route &new_j)
+        {
+            i.push_back(index_i);
+            j.push_back(index_j);
+
+            const std::array<const Route *, 2> routes = {&new_i, &new_j};
+            for (std::size_t side = 0; side < 2; side++)
+            {
+                const auto &route = *routes[side];
+                distance[side].push_back(route.distance);
+                service_time[side].push_back(route.service_time);
+                weight[side].push_back(route.weight);
+
+                // A route left with no customers is removed
+                arcs[side].push_back(route.size > 2 ? route.size - 1 : 0);
+                kept[side].push_back(route.kept);
+            }
+        }
+
+        std::size_t size() const
+        {
+            return i.size();
+        }
+
+        /** @brief Compute the bounds of all candidates. */
+        void evaluate()
+        {
+            const auto n = size();
+            working_time.resize(n);
+            capacity_violation.resize(n);
+            waiting_time_violation.assign(n, _base_waiting_time_violation);
+
+            const double *distance_i = distance[0].data(), *distance_j = distance[1].data();
+            const double *service_time_i = service_time[0].data(), *service_time_j = service_time[1].data();
+            const double *weight_i = weight[0].data(), *weight_j = weight[1].data();
+            const double *arcs_i = arcs[0].data(), *arcs_j = arcs[1].data();
+
+            // Both sides of the same vehicle add up, whereas different vehicles only bound the makespan
+            if (_same_vehicle)
+            {
+                for (std::size_t k = 0; k < n; k++)
+                {
+                    working_time[k] = _base_working_time[0] +
+                                      arcs_i[k] * _per_arc[0] + distance_i[k] * _per_distance[0] + service_time_i[k] +
+                                      arcs_j[k] * _per_arc[1] + distance_j[k] * _per_distance[1] + service_time_j[k];
+                }
+            }
+            else
+            {
+                for (std::size_t k = 0; k < n; k++)
+                {
+                    working_time[k] = std::max(
+                        _base_working_time[0] + arcs_i[k] * _per_arc[0] + distance_i[k] * _per_distance[0] + service_time_i[k],
+                        _base_working_time[1] + arcs_j[k] * _per_arc[1] + distance_j[k] * _per_distance[1] + service_time_j[k]);
+                }
+            }
+
+            for (std::size_t k = 0; k < n; k++)
+            {
+                working_time[k] *= 1 - _tolerance;
+                capacity_violation[k] = std::max(
+                    0.0,
+                    (_base_capacity_violation + std::max(0.0, weight_i[k] - _capacity[0]) + std::max(0.0, weight_j[k] - _capacity[1])) * (1 - _tolerance) -
+                        _tolerance);
+            }
+
+            // Customers kept at the front of a drone route are delayed by the change in working time of the route
+            for (std::size_t side = 0; side < 2; side++)
+            {
+                const auto route = _drone_route[side];
+                if (route == nullptr)
+                {
+                    continue;
+                }
+
+                const auto &slack = route->waiting_time_slack();
+                for (std::size_t k = 0; k < n; k++)
+                {
+                    const double new_working_time = arcs[side][k] * _per_arc[side] + distance[side][k] * _per_distance[side] + service_time[side][k];
+                    waiting_time_violation[k] += slack.delayed_violation(kept[side][k], new_working_time - route->working_time());
+                }
+            }
+
+            for (std::size_t k = 0; k < n; k++)
+            {
+                waiting_time_violation[k] = std::max(0.0, waiting_time_violation[k] * (1 - _tolerance) - _tolerance);
+            }
+        }
+
+        /** @brief The lower bound of the evaluation of the vehicles modified by candidate `k`. */
+        typename ST::PartialEvaluation bound(const std::size_t &k) const
+        {
+            typename ST::PartialEvaluation result;
+            result.working_time = working_time[k];
+            result.capacity_violation = capacity_violation[k];
+            result.waiting_time_violation = waiting_time_violation[k];
+            return result;
+        }
+    };
+}
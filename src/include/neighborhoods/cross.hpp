@@ -1,126 +1,74 @@
 #pragma once
 
-#include "abc.hpp"
+#include "summary.hpp"
 
 namespace d2d
 {
+    /**
+     * @brief Exchange a segment of a route with a segment of another route.
+     *
+     * Segments are at most `Problem::cross_exchange_length` customers long. Each candidate exchange is first
+     * checked against an `O(1)` lower bound of the resulting cost, computed from prefix sums over the routes:
+     * drone working times are exact, truck working times assume the fastest speed throughout, and capacity
+     * violations are exact while other violations are bounded by 0. Route pairs are visited in increasing order of
+     * the bound over unaffected vehicles, so that the search stops once no remaining pair can produce a useful
+     * solution.
+     */
     template <typename ST>
     class CrossExchange : public Neighborhood<ST, false>
     {
     private:
-        template <typename _RT_I, typename _RT_J, std::enable_if_t<is_route_v<_RT_I, _RT_J>, bool> = true>
-        void _inter_route_internal(
-            const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
-            const std::shared_ptr<ParentInfo<ST>> parent,
-            std::shared_ptr<ST> &result,
-            std::vector<std::vector<TruckRoute>> &truck_routes,
-            std::vector<std::vector<DroneRoute>> &drone_routes,
-            const std::size_t &vehicle_i,
-            const std::size_t &vehicle_j)
+        /** @brief Prefix sums over a route, each entry `k` covering customers `[0, k)`. */
+        struct _Prefix
         {
-            auto problem = Problem::get_instance();
+            /** @brief Traveling distance from the first customer to customer `k`. */
+            std::vector<double> distance;
 
-            std::size_t _vehicle_i = utils::ternary<std::is_same_v<_RT_I, TruckRoute>>(vehicle_i, vehicle_i - problem->trucks_count);
-            std::size_t _vehicle_j = utils::ternary<std::is_same_v<_RT_J, TruckRoute>>(vehicle_j, vehicle_j - problem->trucks_count);
+            std::vector<double> weight, truck_service_time, drone_service_time;
+            std::vector<std::size_t> non_dronable;
+        };
 
-            auto &vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(truck_routes, drone_routes);
-            auto &vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(truck_routes, drone_routes);
-            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes, solution->drone_routes);
-            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes, solution->drone_routes);
-
-            for (std::size_t route_i = 0; route_i < original_vehicle_routes_i[_vehicle_i].size(); route_i++)
+        static _Prefix _calculate_prefix(const RouteCustomers &customers)
+        {
+            auto problem = Problem::get_instance();
+            _Prefix prefix;
+            prefix.distance.resize(customers.size());
+            prefix.weight.resize(customers.size() + 1);
+            prefix.truck_service_time.resize(customers.size() + 1);
+            prefix.drone_service_time.resize(customers.size() + 1);
+            prefix.non_dronable.resize(customers.size() + 1);
+            for (std::size_t k = 0; k < customers.size(); k++)
             {
-                for (std::size_t route_j = 0; route_j < original_vehicle_routes_j[_vehicle_j].size(); route_j++)
+                const auto &customer = problem->customers[customers[k]];
+                if (k > 0)
                 {
-                    if constexpr (std::is_same_v<_RT_I, _RT_J>)
-                    {
-                        if (_vehicle_i == _vehicle_j && route_i >= route_j)
-                        {
-                            route_j = route_i;
-                            continue;
-                        }
-                    }
+                    prefix.distance[k] = prefix.distance[k - 1] + problem->distances[customers[k - 1]][customers[k]];
+                }
 
-                    const auto &customers_i = original_vehicle_routes_i[_vehicle_i][route_i].customers();
-                    const auto &customers_j = original_vehicle_routes_j[_vehicle_j][route_j].customers();
+                prefix.weight[k + 1] = prefix.weight[k] + customer.demand;
+                prefix.truck_service_time[k + 1] = prefix.truck_service_time[k] + customer.truck_service_time;
+                prefix.drone_service_time[k + 1] = prefix.drone_service_time[k] + customer.drone_service_time;
+                prefix.non_dronable[k + 1] = prefix.non_dronable[k] + !problem->drone_serviceable[customers[k]];
+            }
 
-                    for (std::size_t i = 1; i < customers_i.size(); i++)
-                    {
-                        for (std::size_t ix = i; ix < customers_i.size(); ix++)
-                        {
-                            if constexpr (std::is_same_v<_RT_I, TruckRoute> && std::is_same_v<_RT_J, DroneRoute>)
-                            {
-                                if (std::any_of(
-                                        customers_i.begin() + i, customers_i.begin() + ix,
-                                        [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
-                                {
-                                    continue;
-                                }
-                            }
+            return prefix;
+        }
 
-                            for (std::size_t j = 1; j < customers_j.size(); j++)
-                            {
-                                for (std::size_t jx = j; jx < customers_j.size(); jx++)
-                                {
-                                    if constexpr (std::is_same_v<_RT_J, TruckRoute> && std::is_same_v<_RT_I, DroneRoute>)
-                                    {
-                                        if (std::any_of(
-                                                customers_j.begin() + j, customers_j.begin() + jx,
-                                                [&problem](const std::size_t &c)
-                                                { return !problem->customers[c].dronable; }))
-                                        {
-                                            continue;
-                                        }
-                                    }
-
-                                    /* Swap [i, ix) of route_i and [j, jx) of route_j */
-                                    std::vector<std::size_t> ri(customers_i.begin(), customers_i.begin() + i);
-                                    std::vector<std::size_t> rj(customers_j.begin(), customers_j.begin() + j);
-
-                                    ri.insert(ri.end(), customers_j.begin() + j, customers_j.begin() + jx);
-                                    rj.insert(rj.end(), customers_i.begin() + i, customers_i.begin() + ix);
-
-                                    ri.insert(ri.end(), customers_i.begin() + ix, customers_i.end());
-                                    rj.insert(rj.end(), customers_j.begin() + jx, customers_j.end());
-
-                                    // Keep in mind that index of route i < j < k
-                                    if (rj.size() == 2)
-                                    {
-                                        vehicle_routes_j[_vehicle_j].erase(vehicle_routes_j[_vehicle_j].begin() + route_j);
-                                    }
-                                    else
-                                    {
-                                        vehicle_routes_j[_vehicle_j][route_j] = _RT_J(rj);
-                                    }
-                                    if (ri.size() == 2)
-                                    {
-                                        vehicle_routes_i[_vehicle_i].erase(vehicle_routes_i[_vehicle_i].begin() + route_i);
-                                    }
-                                    else
-                                    {
-                                        vehicle_routes_i[_vehicle_i][route_i] = _RT_I(ri);
-                                    }
-
-                                    auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                                    if (aspiration_criteria(new_solution) && (result == nullptr || new_solution->cost() < result->cost()))
-                                    {
-                                        result = new_solution;
-                                    }
-
-                                    /* Restore */
-                                    vehicle_routes_i[_vehicle_i] = original_vehicle_routes_i[_vehicle_i];
-                                    if (vehicle_i != vehicle_j)
-                                    {
-                                        vehicle_routes_j[_vehicle_j] = original_vehicle_routes_j[_vehicle_j];
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+        /**
+         * @brief Lower bound of the working time of a route.
+         *
+         * @param arcs The number of arcs of the route
+         * @param service_time Total service time, excluding the final depot
+         */
+        static double _working_time_bound(const bool &drone, const double &distance, const std::size_t &arcs, const double &service_time)
+        {
+            auto problem = Problem::get_instance();
+            if (drone)
+            {
+                return arcs * (problem->drone->takeoff_time() + problem->drone->landing_time()) + problem->drone->cruise_time(distance) + service_time;
             }
+
+            return distance / problem->truck->maximum_speed + service_time;
         }
 
     public:
@@ -129,60 +77,245 @@ namespace d2d
             return "CROSS-exchange";
         }
 
+        template <typename _AspirationCriteria>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AspirationCriteria &aspiration_criteria)
         {
             return std::make_pair(nullptr, std::vector<std::size_t>());
         }
 
+        template <typename _AspirationCriteria>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AspirationCriteria &aspiration_criteria)
         {
             auto problem = Problem::get_instance();
             auto parent = this->parent_ptr(solution);
             std::shared_ptr<ST> result;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            const RouteSummaries summaries(solution);
+            const auto &routes = summaries.routes;
+            const double capacity_coefficient = ST::penalty_coefficients()[1];
+            const std::size_t max_length = problem->cross_exchange_length == 0 ? problem->customers.size() : problem->cross_exchange_length;
+
+            /* Route summaries */
+            std::vector<std::size_t> existing;
+            std::vector<_Prefix> prefixes(routes.size());
+            std::vector<double> working_time_bound(routes.size()), capacity_violation(routes.size());
+            std::vector<double> vehicle_bound(summaries.working_time);
+            for (std::size_t route = 0; route < routes.size(); route++)
+            {
+                if (routes[route].customers == nullptr)
+                {
+                    continue;
+                }
+
+                const auto &customers = *routes[route].customers;
+                const auto &prefix = prefixes[route] = _calculate_prefix(customers);
+                const auto &service_time = routes[route].drone ? prefix.drone_service_time : prefix.truck_service_time;
+
+                existing.push_back(route);
+                working_time_bound[route] = _working_time_bound(routes[route].drone, prefix.distance.back(), customers.size() - 1, service_time[customers.size() - 1]);
+                capacity_violation[route] = std::max(0.0, prefix.weight.back() - (routes[route].drone ? problem->drone->capacity : problem->truck->capacity));
+            }
+
+            // Truck working times are replaced by the sum of bounds of their routes, drone working times are exact
+            for (std::size_t route = 0; route < routes.size(); route++)
+            {
+                if (!routes[route].drone && routes[route].index == 0)
+                {
+                    vehicle_bound[routes[route].global_vehicle] = 0;
+                }
+            }
+
+            for (auto &route : existing)
+            {
+                if (!routes[route].drone)
+                {
+                    vehicle_bound[routes[route].global_vehicle] += working_time_bound[route];
+                }
+            }
+
+            const double total_capacity_violation = std::accumulate(capacity_violation.begin(), capacity_violation.end(), 0.0);
+
+            /* The 3 vehicles with the largest working times, enough to exclude the 2 vehicles of a route pair */
+            std::vector<std::size_t> busiest(summaries.working_time.size());
+            std::iota(busiest.begin(), busiest.end(), 0);
+            std::sort(
+                busiest.begin(), busiest.end(),
+                [&summaries](const std::size_t &first, const std::size_t &second)
+                {
+                    return summaries.working_time[first] > summaries.working_time[second];
+                });
+            busiest.resize(std::min<std::size_t>(busiest.size(), 3));
+
+            const auto unaffected_makespan = [&summaries, &busiest](const std::size_t &vehicle_i, const std::size_t &vehicle_j)
+            {
+                for (auto &vehicle : busiest)
+                {
+                    if (vehicle != vehicle_i && vehicle != vehicle_j)
+                    {
+                        return summaries.working_time[vehicle];
+                    }
+                }
+
+                return 0.0;
+            };
+
+            /* Route pairs with their bound over unaffected vehicles and routes */
+            struct _Pair
+            {
+                double bound;
+                std::size_t route_i, route_j;
+            };
 
-            for (std::size_t vehicle_i = 0; vehicle_i < problem->trucks_count + problem->drones_count; vehicle_i++)
+            std::vector<_Pair> pairs;
+            for (std::size_t i = 0; i < existing.size(); i++)
             {
-                for (std::size_t vehicle_j = vehicle_i; vehicle_j < problem->trucks_count + problem->drones_count; vehicle_j++)
+                for (std::size_t j = i + 1; j < existing.size(); j++)
                 {
-                    if (vehicle_j < problem->trucks_count)
+                    const auto &route_i = existing[i], &route_j = existing[j];
+                    if (!routes[route_i].geometry->near(*routes[route_j].geometry))
                     {
-                        _inter_route_internal<TruckRoute, TruckRoute>(
-                            solution,
-                            aspiration_criteria,
-                            parent, result,
-                            truck_routes,
-                            drone_routes,
-                            vehicle_i,
-                            vehicle_j);
+                        continue;
                     }
-                    else if (vehicle_i < problem->trucks_count)
+
+                    double bound = unaffected_makespan(routes[route_i].global_vehicle, routes[route_j].global_vehicle) +
+                                   capacity_coefficient * (total_capacity_violation - capacity_violation[route_i] - capacity_violation[route_j]);
+                    pairs.push_back({bound, route_i, route_j});
+                }
+            }
+
+            std::sort(
+                pairs.begin(), pairs.end(),
+                [](const _Pair &first, const _Pair &second)
+                {
+                    return first.bound < second.bound;
+                });
+
+            // A candidate is useless if it can neither become the result nor improve the current solution
+            const auto threshold = [&solution, &result]()
+            {
+                return result == nullptr ? std::numeric_limits<double>::max() : std::max(result->cost().value, solution->cost().value);
+            };
+
+            ScratchRoutes scratch(solution);
+            for (auto &pair : pairs)
+            {
+                if (pair.bound >= threshold())
+                {
+                    break;
+                }
+
+                const auto &route_i = pair.route_i, &route_j = pair.route_j;
+                const auto &ref_i = routes[route_i], &ref_j = routes[route_j];
+                const auto &customers_i = *ref_i.customers, &customers_j = *ref_j.customers;
+                const auto &prefix_i = prefixes[route_i], &prefix_j = prefixes[route_j];
+                const auto &vehicle_i = ref_i.global_vehicle, &vehicle_j = ref_j.global_vehicle;
+
+                /**
+                 * Working time bound and capacity violation of `route` after replacing its segment `[a, ax)` with
+                 * segment `[b, bx)` of `other`
+                 */
+                const auto replaced = [&problem, &routes, &prefixes](
+                                          const std::size_t &route, const std::size_t &a, const std::size_t &ax,
+                                          const std::size_t &other, const std::size_t &b, const std::size_t &bx)
+                {
+                    const auto &customers = *routes[route].customers, &other_customers = *routes[other].customers;
+                    const auto &prefix = prefixes[route], &other_prefix = prefixes[other];
+                    const bool drone = routes[route].drone;
+
+                    double distance = prefix.distance[a - 1] + prefix.distance.back() - prefix.distance[ax];
+                    if (b == bx)
                     {
-                        _inter_route_internal<TruckRoute, DroneRoute>(
-                            solution,
-                            aspiration_criteria,
-                            parent, result,
-                            truck_routes,
-                            drone_routes,
-                            vehicle_i,
-                            vehicle_j);
+                        distance += problem->distances[customers[a - 1]][customers[ax]];
                     }
                     else
                     {
-                        _inter_route_internal<DroneRoute, DroneRoute>(
-                            solution,
-                            aspiration_criteria,
-                            parent, result,
-                            truck_routes,
-                            drone_routes,
-                            vehicle_i,
-                            vehicle_j);
+                        distance += problem->distances[customers[a - 1]][other_customers[b]] +
+                                    other_prefix.distance[bx - 1] - other_prefix.distance[b] +
+                                    problem->distances[other_customers[bx - 1]][customers[ax]];
+                    }
+
+                    const auto &service_time = drone ? prefix.drone_service_time : prefix.truck_service_time;
+                    const auto &other_service_time = drone ? other_prefix.drone_service_time : other_prefix.truck_service_time;
+
+                    std::size_t size = customers.size() - (ax - a) + (bx - b);
+                    double time = _working_time_bound(
+                        drone, distance, size - 1,
+                        service_time[customers.size() - 1] - (service_time[ax] - service_time[a]) + (other_service_time[bx] - other_service_time[b]));
+
+                    double weight = prefix.weight.back() - (prefix.weight[ax] - prefix.weight[a]) + (other_prefix.weight[bx] - other_prefix.weight[b]);
+                    double capacity = drone ? problem->drone->capacity : problem->truck->capacity;
+                    return std::make_pair(time, std::max(0.0, weight - capacity));
+                };
+
+                for (std::size_t i = 1; i < customers_i.size(); i++)
+                {
+                    for (std::size_t ix = i; ix < customers_i.size() && ix - i <= max_length; ix++)
+                    {
+                        if (ref_j.drone && prefix_i.non_dronable[ix] != prefix_i.non_dronable[i])
+                        {
+                            break;
+                        }
+
+                        for (std::size_t j = 1; j < customers_j.size(); j++)
+                        {
+                            for (std::size_t jx = j; jx < customers_j.size() && jx - j <= max_length; jx++)
+                            {
+                                if (ref_i.drone && prefix_j.non_dronable[jx] != prefix_j.non_dronable[j])
+                                {
+                                    break;
+                                }
+
+                                if (i == ix && j == jx)
+                                {
+                                    continue;
+                                }
+
+                                /* Lower bound of the resulting cost */
+                                auto [time_i, violation_i] = replaced(route_i, i, ix, route_j, j, jx);
+                                auto [time_j, violation_j] = replaced(route_j, j, jx, route_i, i, ix);
+
+                                double bound_i = vehicle_bound[vehicle_i] - working_time_bound[route_i] + time_i,
+                                       bound_j = vehicle_bound[vehicle_j] - working_time_bound[route_j] + time_j;
+                                if (vehicle_i == vehicle_j)
+                                {
+                                    bound_i = bound_j = bound_i - working_time_bound[route_j] + time_j;
+                                }
+
+                                double bound = std::max({unaffected_makespan(vehicle_i, vehicle_j), bound_i, bound_j}) +
+                                               capacity_coefficient * (total_capacity_violation - capacity_violation[route_i] - capacity_violation[route_j] + violation_i + violation_j);
+                                if (bound >= threshold())
+                                {
+                                    continue;
+                                }
+
+                                /* Swap [i, ix) of route_i and [j, jx) of route_j */
+                                std::vector<std::size_t> ri(customers_i.begin(), customers_i.begin() + i);
+                                std::vector<std::size_t> rj(customers_j.begin(), customers_j.begin() + j);
+
+                                ri.insert(ri.end(), customers_j.begin() + j, customers_j.begin() + jx);
+                                rj.insert(rj.end(), customers_i.begin() + i, customers_i.begin() + ix);
+
+                                ri.insert(ri.end(), customers_i.begin() + ix, customers_i.end());
+                                rj.insert(rj.end(), customers_j.begin() + jx, customers_j.end());
+
+                                std::vector<RouteSummaries::Modification> modified;
+                                modified.emplace_back(route_i, std::move(ri));
+                                modified.emplace_back(route_j, std::move(rj));
+
+                                summaries.apply(modified, scratch);
+                                auto new_solution = this->construct(parent, solution, scratch, result);
+                                if (new_solution != nullptr && aspiration_criteria(new_solution) && (result == nullptr || new_solution->cost() < result->cost()))
+                                {
+                                    result = new_solution;
+                                }
+
+                                scratch.undo();
+                            }
+                        }
                     }
                 }
             }
@@ -0,0 +1,271 @@
+#pragma once
+
+#include "summary.hpp"
+
+namespace d2d
+{
+    /**
+     * @brief Cyclic transfers of segments among 3 or more routes.
+     *
+     * Nodes of the transfer graph are segments of at most `_max_segment` consecutive customers (including empty
+     * segments, i.e. insertion points). An arc from segment `a` to segment `b` of another route means `a` takes
+     * the place of `b`, and its cost is the estimated change in working time of `b`'s route. Only the
+     * `_arcs_per_segment` cheapest arcs of each segment are kept. Improving cycles of up to `_max_length` routes
+     * are searched depth-first, pruning paths whose partial cost is not negative. Cycles are ranked by the
+     * working time of the most loaded vehicle they would produce, and only the most promising ones are evaluated
+     * exactly.
+     */
+    template <typename ST>
+    class CyclicExchange : public Neighborhood<ST, false>
+    {
+    private:
+        static constexpr std::size_t _max_segment = 3;
+        static constexpr std::size_t _max_length = 4;
+        static constexpr std::size_t _arcs_per_segment = 10;
+
+        /** @brief Customers `[begin, end)` of a route. */
+        struct _Segment
+        {
+            std::size_t route, begin, end;
+
+            /** @brief Traveling distance inside the segment. */
+            double distance;
+
+            double truck_service_time, drone_service_time;
+            bool dronable;
+        };
+
+        struct _Arc
+        {
+            double cost;
+            std::size_t to;
+        };
+
+        struct _Cycle
+        {
+            /** @brief Estimated working time of the most loaded vehicle after applying this cycle. */
+            double makespan;
+
+            /** @brief Estimated change in total working time. */
+            double cost;
+
+            std::array<std::size_t, _max_length> segments;
+            std::size_t length;
+        };
+
+    public:
+        std::string label() const override
+        {
+            return "Cyclic exchange";
+        }
+
+        template <typename _AspirationCriteria>
+        std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
+            const std::shared_ptr<ST> solution,
+            const _AspirationCriteria &aspiration_criteria)
+        {
+            return std::make_pair(nullptr, std::vector<std::size_t>());
+        }
+
+        template <typename _AspirationCriteria>
+        std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
+            const std::shared_ptr<ST> solution,
+            const _AspirationCriteria &aspiration_criteria)
+        {
+            auto problem = Problem::get_instance();
+            const RouteSummaries summaries(solution);
+            const auto &routes = summaries.routes;
+
+            /* Transfer graph nodes */
+            std::vector<_Segment> segments;
+            for (std::size_t route = 0; route < routes.size(); route++)
+            {
+                if (routes[route].customers == nullptr)
+                {
+                    continue;
+                }
+
+                const auto &customers = *routes[route].customers;
+                for (std::size_t begin = 1; begin < customers.size(); begin++)
+                {
+                    _Segment segment{route, begin, begin, 0.0, 0.0, 0.0, true};
+                    segments.push_back(segment);
+                    for (std::size_t end = begin + 1; end < customers.size() && end - begin <= _max_segment; end++)
+                    {
+                        const auto &customer = customers[end - 1];
+                        if (end - begin > 1)
+                        {
+                            segment.distance += problem->distances[customers[end - 2]][customer];
+                        }
+
+                        segment.end = end;
+                        segment.truck_service_time += problem->customers[customer].truck_service_time;
+                        segment.drone_service_time += problem->customers[customer].drone_service_time;
+                        segment.dronable = segment.dronable && problem->drone_serviceable[customer];
+                        segments.push_back(segment);
+                    }
+                }
+            }
+
+            /* Estimated change in working time of the route of `to` when `from` takes its place */
+            const auto arc_cost = [&problem, &routes, &segments](const std::size_t &from, const std::size_t &to)
+            {
+                const auto &a = segments[from], &b = segments[to];
+                if (a.route == b.route || (a.begin == a.end && b.begin == b.end) || (routes[b.route].drone && !a.dronable))
+                {
+                    return std::numeric_limits<double>::max();
+                }
+
+                // Segments only move between routes near each other
+                if (a.begin != a.end && !routes[a.route].geometry->near(*routes[b.route].geometry))
+                {
+                    return std::numeric_limits<double>::max();
+                }
+
+                const auto &customers_a = *routes[a.route].customers, &customers_b = *routes[b.route].customers;
+                const auto &prev = customers_b[b.begin - 1], &next = customers_b[b.end];
+
+                double removed = b.begin == b.end
+                                     ? problem->distances[prev][next]
+                                     : problem->distances[prev][customers_b[b.begin]] + b.distance + problem->distances[customers_b[b.end - 1]][next];
+                double placed = a.begin == a.end
+                                    ? problem->distances[prev][next]
+                                    : problem->distances[prev][customers_a[a.begin]] + a.distance + problem->distances[customers_a[a.end - 1]][next];
+
+                const bool drone = routes[b.route].drone;
+                return routes[b.route].time_factor * (placed - removed) +
+                       (drone ? a.drone_service_time - b.drone_service_time : a.truck_service_time - b.truck_service_time);
+            };
+
+            /* Keep only the cheapest arcs of each node */
+            std::vector<std::vector<_Arc>> arcs(segments.size());
+            for (std::size_t from = 0; from < segments.size(); from++)
+            {
+                for (std::size_t to = 0; to < segments.size(); to++)
+                {
+                    double cost = arc_cost(from, to);
+                    if (cost != std::numeric_limits<double>::max())
+                    {
+                        arcs[from].push_back({cost, to});
+                    }
+                }
+
+                const auto limit = std::min(arcs[from].size(), _arcs_per_segment);
+                std::partial_sort(
+                    arcs[from].begin(), arcs[from].begin() + limit, arcs[from].end(),
+                    [](const _Arc &first, const _Arc &second)
+                    {
+                        return first.cost < second.cost;
+                    });
+                arcs[from].resize(limit);
+            }
+
+            /* Depth-first search for improving cycles */
+            std::vector<_Cycle> cycles;
+            std::set<std::array<std::size_t, _max_length>> found;
+            std::array<std::size_t, _max_length> path;
+            std::array<double, _max_length> costs;
+            const auto search = [&](const auto &self, const std::size_t &length, const double &cost) -> void
+            {
+                const auto &last = path[length - 1];
+                if (length >= 3)
+                {
+                    double closing = arc_cost(last, path[0]);
+                    if (closing != std::numeric_limits<double>::max() && cost + closing < 0)
+                    {
+                        // The same cycle is found from each of its nodes, keep only one rotation
+                        std::array<std::size_t, _max_length> key;
+                        key.fill(segments.size());
+
+                        auto first = std::min_element(path.begin(), path.begin() + length);
+                        std::rotate_copy(path.begin(), first, path.begin() + length, key.begin());
+                        if (found.insert(key).second)
+                        {
+                            std::vector<std::pair<std::size_t, double>> deltas;
+                            for (std::size_t i = 1; i < length; i++)
+                            {
+                                deltas.emplace_back(segments[path[i]].route, costs[i]);
+                            }
+                            deltas.emplace_back(segments[path[0]].route, closing);
+
+                            cycles.push_back({summaries.makespan(deltas), cost + closing, path, length});
+                        }
+                    }
+                }
+
+                if (length == _max_length)
+                {
+                    return;
+                }
+
+                for (auto &arc : arcs[last])
+                {
+                    const auto &route = segments[arc.to].route;
+                    if (std::any_of(
+                            path.begin(), path.begin() + length,
+                            [&segments, &route](const std::size_t &segment)
+                            { return segments[segment].route == route; }))
+                    {
+                        continue;
+                    }
+
+                    // Gain criterion: every improving cycle has a rotation whose partial sums are all negative
+                    if (cost + arc.cost < 0)
+                    {
+                        path[length] = arc.to;
+                        costs[length] = arc.cost;
+                        self(self, length + 1, cost + arc.cost);
+                    }
+                }
+            };
+
+            for (std::size_t start = 0; start < segments.size(); start++)
+            {
+                path[0] = start;
+                costs[0] = 0;
+                search(search, 1, 0.0);
+            }
+
+            /* Evaluate the most promising cycles exactly */
+            const auto limit = std::min(cycles.size(), problem->customers.size());
+            std::partial_sort(
+                cycles.begin(), cycles.begin() + limit, cycles.end(),
+                [](const _Cycle &first, const _Cycle &second)
+                {
+                    return std::tie(first.makespan, first.cost) < std::tie(second.makespan, second.cost);
+                });
+
+            auto parent = this->parent_ptr(solution);
+            std::shared_ptr<ST> result;
+
+            ScratchRoutes scratch(solution);
+            for (std::size_t c = 0; c < limit; c++)
+            {
+                const auto &cycle = cycles[c];
+
+                std::vector<RouteSummaries::Modification> modified;
+                for (std::size_t i = 0; i < cycle.length; i++)
+                {
+                    const auto &from = segments[cycle.segments[i]], &to = segments[cycle.segments[(i + 1) % cycle.length]];
+                    const auto &customers_from = *routes[from.route].customers, &customers_to = *routes[to.route].customers;
+
+                    std::vector<std::size_t> customers(customers_to.begin(), customers_to.begin() + to.begin);
+                    customers.insert(customers.end(), customers_from.begin() + from.begin, customers_from.begin() + from.end);
+                    customers.insert(customers.end(), customers_to.begin() + to.end, customers_to.end());
+                    modified.emplace_back(to.route, std::move(customers));
+                }
+
+                summaries.apply(modified, scratch);
+                auto new_solution = this->construct(parent, solution, scratch, result);
+                if (new_solution != nullptr && aspiration_criteria(new_solution) && (result == nullptr || new_solution->cost() < result->cost()))
+                {
+                    result = new_solution;
+                }
+
+                scratch.undo();
+            }
+
+            return std::make_pair(result, std::vector<std::size_t>());
+        }
+    };
+}
@@ -1,173 +1,87 @@
 #pragma once
 
-#include "abc.hpp"
+#include "summary.hpp"
+#include "../spatial.hpp"
 
 namespace d2d
 {
+    /**
+     * @brief Ejection chains searched as negative-cost paths in an improvement graph.
+     *
+     * Nodes of the graph are customers. A chain ejects a customer from its route, inserts it into another route
+     * while ejecting a customer there, and so on, until the last ejected customer is inserted into a route outside
+     * the chain (or into a new route). Arc costs are estimated changes in working time computed from route
+     * summaries, and chains of at most `_max_depth` ejections are searched with a layered dynamic program over
+     * the nearest neighbors of each customer. Chains are then ranked by the working time of the most loaded
+     * vehicle they would produce, and only the most promising ones are evaluated exactly.
+     */
     template <typename ST>
     class EjectionChain : public Neighborhood<ST, false>
     {
     private:
-        template <typename _RT_I, typename _RT_J, typename _RT_K, std::enable_if_t<is_route_v<_RT_I, _RT_J, _RT_K>, bool> = true>
-        void _inter_route_internal(
-            const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
-            const std::shared_ptr<ParentInfo<ST>> parent,
-            std::shared_ptr<ST> &result,
-            std::vector<std::vector<TruckRoute>> &truck_routes,
-            std::vector<std::vector<DroneRoute>> &drone_routes,
-            const std::size_t &vehicle_i,
-            const std::size_t &vehicle_j,
-            const std::size_t &vehicle_k)
-        {
-            auto problem = Problem::get_instance();
-
-            std::size_t _vehicle_i = utils::ternary<std::is_same_v<_RT_I, TruckRoute>>(vehicle_i, vehicle_i - problem->trucks_count);
-            std::size_t _vehicle_j = utils::ternary<std::is_same_v<_RT_J, TruckRoute>>(vehicle_j, vehicle_j - problem->trucks_count);
-            std::size_t _vehicle_k = utils::ternary<std::is_same_v<_RT_K, TruckRoute>>(vehicle_k, vehicle_k - problem->trucks_count);
-
-            auto &vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(truck_routes, drone_routes);
-            auto &vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(truck_routes, drone_routes);
-            auto &vehicle_routes_k = utils::match_type<std::vector<std::vector<_RT_K>>>(truck_routes, drone_routes);
-
-            auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes, solution->drone_routes);
-            auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes, solution->drone_routes);
-            auto &original_vehicle_routes_k = utils::match_type<std::vector<std::vector<_RT_K>>>(solution->truck_routes, solution->drone_routes);
+        static constexpr std::size_t _max_depth = 5;
+        static constexpr std::size_t _neighbors_count = 16;
+        static constexpr std::size_t _npos = std::numeric_limits<std::size_t>::max();
 
-            // std::cerr << "\e[31mInitial state:" << std::endl;
-            // std::cerr << original_vehicle_routes_i << std::endl;
-            // std::cerr << original_vehicle_routes_j << std::endl;
-            // std::cerr << original_vehicle_routes_k << "\e[0m\n";
-
-            for (std::size_t route_i = 0; route_i < original_vehicle_routes_i[_vehicle_i].size(); route_i++)
-            {
-                const auto &customers_i = original_vehicle_routes_i[_vehicle_i][route_i].customers();
-                for (std::size_t i = 1; i + 1 < customers_i.size(); i++)
-                {
-                    if constexpr (std::is_same_v<_RT_I, TruckRoute> && std::is_same_v<_RT_J, DroneRoute>)
-                    {
-                        if (!problem->customers[customers_i[i]].dronable)
-                        {
-                            continue;
-                        }
-                    }
+        /** @brief A candidate insertion of a customer into a route. */
+        struct _Insertion
+        {
+            double cost;
+            std::size_t route, position;
+        };
 
-                    for (std::size_t route_j = 0; route_j < original_vehicle_routes_j[_vehicle_j].size(); route_j++)
-                    {
-                        if constexpr (std::is_same_v<_RT_I, _RT_J>)
-                        {
-                            if (_vehicle_i == _vehicle_j && route_i == route_j) /* same route */
-                            {
-                                continue;
-                            }
-                        }
+        /** @brief The best chain reaching a customer after a number of ejections. */
+        struct _Label
+        {
+            double cost = std::numeric_limits<double>::max();
 
-                        const auto &customers_j = original_vehicle_routes_j[_vehicle_j][route_j].customers();
-                        for (std::size_t jx = 1; jx < customers_j.size(); jx++)
-                        {
-                            for (std::size_t jy = 1; jy < customers_j.size(); jy++) /* Inserting customers_i[i] to customers_j[jx] increases size by 1 */
-                            {
-                                if (jx == jy) /* Route j is intact */
-                                {
-                                    continue;
-                                }
+            /** @brief The previously ejected customer, or `_npos` if the chain starts here. */
+            std::size_t previous = _npos;
 
-                                if constexpr (std::is_same_v<_RT_J, TruckRoute> && std::is_same_v<_RT_K, DroneRoute>)
-                                {
-                                    if (!problem->customers[customers_j[jy - (jy > jx)]].dronable)
-                                    {
-                                        continue;
-                                    }
-                                }
+            /** @brief Position to insert `previous` into the route of this customer after ejecting it. */
+            std::size_t position = 0;
+        };
 
-                                /* Construct temporaries and temporary state lv1 */
-                                std::vector<std::size_t> ri(customers_i), rj(customers_j);
-                                ri.erase(ri.begin() + i);
-                                rj.insert(rj.begin() + jx, customers_i[i]);
-                                rj.erase(rj.begin() + jy);
+        struct _Chain
+        {
+            /** @brief Estimated working time of the most loaded vehicle after applying this chain. */
+            double makespan;
 
-                                std::size_t insert_k = customers_j[jy - (jy > jx)];
-                                vehicle_routes_j[_vehicle_j][route_j] = _RT_J(rj);
-                                if (ri.size() == 2)
-                                {
-                                    vehicle_routes_i[_vehicle_i].erase(vehicle_routes_i[_vehicle_i].begin() + route_i);
-                                }
-                                else
-                                {
-                                    vehicle_routes_i[_vehicle_i][route_i] = _RT_I(ri);
-                                }
+            /** @brief Estimated change in total working time. */
+            double cost;
 
-                                // std::cerr << "Temporary state " << vehicle_routes_i << " " << vehicle_routes_j << ", insert_k = " << insert_k << std::endl;
+            std::size_t depth, customer;
+            _Insertion end;
+        };
 
-                                /* Construct a new route of vehicle_k (temporary state lv2) */
-                                vehicle_routes_k[_vehicle_k].emplace_back(std::vector<std::size_t>{0, insert_k, 0});
+        std::vector<std::vector<std::size_t>> _neighbors;
 
-                                auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                                if (aspiration_criteria(new_solution) && (result == nullptr || new_solution->cost() < result->cost()))
-                                {
-                                    result = new_solution;
-                                }
+        const std::vector<std::vector<std::size_t>> &_nearest_customers()
+        {
+            if (_neighbors.empty())
+            {
+                auto problem = Problem::get_instance();
+                std::vector<std::size_t> customers(problem->customers.size() - 1);
+                std::iota(customers.begin(), customers.end(), 1);
 
-                                /* Restore temporary state lv1 */
-                                vehicle_routes_k[_vehicle_k].pop_back();
+                std::vector<double> x(problem->customers.size()), y(problem->customers.size());
+                for (std::size_t i = 0; i < problem->customers.size(); i++)
+                {
+                    x[i] = problem->customers[i].x;
+                    y[i] = problem->customers[i].y;
+                }
 
-                                // std::cerr << "1. Restore temporary state " << vehicle_routes_i << " " << vehicle_routes_j << std::endl;
-                                /* Swap customers between 3 existing routes */
-                                bool same_ik = (vehicle_i == vehicle_k);
-                                for (std::size_t route_k = 0; route_k < original_vehicle_routes_k[_vehicle_k].size() - same_ik; route_k++)
-                                {
-                                    if constexpr (std::is_same_v<_RT_J, _RT_K>)
-                                    {
-                                        if (_vehicle_j == _vehicle_k && route_j == route_k) /* same route */
-                                        {
-                                            continue;
-                                        }
-                                    }
-
-                                    if constexpr (std::is_same_v<_RT_K, _RT_I>)
-                                    {
-                                        if (_vehicle_k == _vehicle_i && route_k == route_i) /* same route */
-                                        {
-                                            continue;
-                                        }
-                                    }
-
-                                    std::size_t route_k_new = route_k - (ri.size() == 2 && same_ik && route_k >= route_i);
-                                    const auto &customers_k = original_vehicle_routes_k[_vehicle_k][route_k].customers();
-                                    for (std::size_t k = 1; k < customers_k.size(); k++)
-                                    {
-                                        /* Insert to position k */
-                                        std::vector<std::size_t> rk(customers_k);
-                                        rk.insert(rk.begin() + k, insert_k);
-
-                                        /* Temporary modify (temporary state lv2) */
-                                        vehicle_routes_k[_vehicle_k][route_k_new] = _RT_K(rk);
-
-                                        // std::cerr << "Constructing " << truck_routes << " " << drone_routes << std::endl;
-                                        auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                                        if (aspiration_criteria(new_solution) && (result == nullptr || new_solution->cost() < result->cost()))
-                                        {
-                                            result = new_solution;
-                                        }
-
-                                        /* Restore temporary state lv1 */
-                                        vehicle_routes_k[_vehicle_k][route_k_new] = original_vehicle_routes_k[_vehicle_k][route_k];
-                                        // std::cerr << "2. Restore temporary state " << vehicle_routes_i << " " << vehicle_routes_j << std::endl;
-                                    }
-                                }
+                utils::GridIndex index(customers, x, y);
 
-                                /* Restore */
-                                vehicle_routes_i[_vehicle_i] = original_vehicle_routes_i[_vehicle_i];
-                                if (vehicle_i != vehicle_j)
-                                {
-                                    vehicle_routes_j[_vehicle_j][route_j] = original_vehicle_routes_j[_vehicle_j][route_j];
-                                }
-                                // std::cerr << "3. Restore original state " << vehicle_routes_i << " " << vehicle_routes_j << std::endl;
-                            }
-                        }
-                    }
+                _neighbors.resize(problem->customers.size());
+                for (auto &customer : customers)
+                {
+                    _neighbors[customer] = index.k_nearest(x[customer], y[customer], _neighbors_count + 1);
+                    _neighbors[customer].erase(std::remove(_neighbors[customer].begin(), _neighbors[customer].end(), customer), _neighbors[customer].end());
                 }
             }
+
+            return _neighbors;
         }
 
     public:
@@ -176,156 +90,312 @@ namespace d2d
             return "Ejection chain";
         }
 
+        template <typename _AspirationCriteria>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AspirationCriteria &aspiration_criteria)
         {
             return std::make_pair(nullptr, std::vector<std::size_t>());
         }
 
+        template <typename _AspirationCriteria>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AspirationCriteria &aspiration_criteria)
         {
             auto problem = Problem::get_instance();
-            auto parent = this->parent_ptr(solution);
-            std::shared_ptr<ST> result;
+            const auto &neighbors = _nearest_customers();
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            const RouteSummaries summaries(solution);
+            const auto &routes = summaries.routes;
+            const auto &route_of = summaries.route_of, &position_of = summaries.position_of;
 
-            for (std::size_t vehicle_i = 0; vehicle_i < problem->trucks_count + problem->drones_count; vehicle_i++)
+            /* Time saved by ejecting a customer from its route */
+            std::vector<double> removal_gain(problem->customers.size());
+            for (std::size_t customer = 1; customer < problem->customers.size(); customer++)
             {
-                for (std::size_t vehicle_j = 0; vehicle_j < problem->trucks_count + problem->drones_count; vehicle_j++)
+                const auto &route = route_of[customer];
+                const auto &customers = *routes[route].customers;
+                const auto &prev = customers[position_of[customer] - 1], &next = customers[position_of[customer] + 1];
+
+                removal_gain[customer] = routes[route].time_factor * (problem->distances[prev][customer] + problem->distances[customer][next] - problem->distances[prev][next]) +
+                                         summaries.service_time(route, customer);
+            }
+
+            const auto insertion_cost = [&problem, &routes](const std::size_t &route, const std::size_t &customer, const std::size_t &prev, const std::size_t &next)
+            {
+                return routes[route].time_factor * (problem->distances[prev][customer] + problem->distances[customer][next] - problem->distances[prev][next]);
+            };
+
+            /* Best insertion of `customer` into `route`, without ejecting anyone */
+            const auto best_insertion = [&](const std::size_t &route, const std::size_t &customer)
+            {
+                _Insertion result{std::numeric_limits<double>::max(), route, 1};
+                if (!summaries.allowed(route, customer))
+                {
+                    return result;
+                }
+
+                const double service = summaries.service_time(route, customer);
+                if (routes[route].customers == nullptr)
                 {
-                    for (std::size_t vehicle_k = 0; vehicle_k < problem->trucks_count + problem->drones_count; vehicle_k++)
+                    result.cost = insertion_cost(route, customer, 0, 0) + service;
+                    if (routes[route].drone)
                     {
-                        if (vehicle_i < problem->trucks_count)
+                        result.cost += 2 * (problem->drone->takeoff_time() + problem->drone->landing_time());
+                    }
+
+                    return result;
+                }
+
+                const auto &customers = *routes[route].customers;
+                for (std::size_t i = 1; i < customers.size(); i++)
+                {
+                    double cost = insertion_cost(route, customer, customers[i - 1], customers[i]) + service;
+                    if (cost < result.cost)
+                    {
+                        result.cost = cost;
+                        result.position = i;
+                    }
+                }
+
+                return result;
+            };
+
+            /**
+             * Invoke `callback(ejected, cost, position)` for each customer of `route` which `customer` can replace,
+             * where `position` is an index in the route after ejection. Ejecting a customer invalidates only the
+             * 2 gaps around it, so the 3 cheapest gaps of the route are enough.
+             */
+            const auto for_each_ejection = [&](const std::size_t &route, const std::size_t &customer, const auto &callback)
+            {
+                const auto &customers = *routes[route].customers;
+                const double service = summaries.service_time(route, customer);
+
+                std::array<std::pair<double, std::size_t>, 3> gaps;
+                gaps.fill(std::make_pair(std::numeric_limits<double>::max(), 0));
+                for (std::size_t i = 1; i < customers.size(); i++)
+                {
+                    auto gap = std::make_pair(insertion_cost(route, customer, customers[i - 1], customers[i]), i);
+                    for (auto &g : gaps)
+                    {
+                        if (gap.first < g.first)
                         {
-                            if (vehicle_j < problem->trucks_count)
-                            {
-                                if (vehicle_k < problem->trucks_count)
-                                {
-                                    _inter_route_internal<TruckRoute, TruckRoute, TruckRoute>(
-                                        solution,
-                                        aspiration_criteria,
-                                        parent,
-                                        result,
-                                        truck_routes,
-                                        drone_routes,
-                                        vehicle_i,
-                                        vehicle_j,
-                                        vehicle_k);
-                                }
-                                else
-                                {
-                                    _inter_route_internal<TruckRoute, TruckRoute, DroneRoute>(
-                                        solution,
-                                        aspiration_criteria,
-                                        parent,
-                                        result,
-                                        truck_routes,
-                                        drone_routes,
-                                        vehicle_i,
-                                        vehicle_j,
-                                        vehicle_k);
-                                }
-                            }
-                            else
-                            {
-                                if (vehicle_k < problem->trucks_count)
-                                {
-                                    _inter_route_internal<TruckRoute, DroneRoute, TruckRoute>(
-                                        solution,
-                                        aspiration_criteria,
-                                        parent,
-                                        result,
-                                        truck_routes,
-                                        drone_routes,
-                                        vehicle_i,
-                                        vehicle_j,
-                                        vehicle_k);
-                                }
-                                else
-                                {
-                                    _inter_route_internal<TruckRoute, DroneRoute, DroneRoute>(
-                                        solution,
-                                        aspiration_criteria,
-                                        parent,
-                                        result,
-                                        truck_routes,
-                                        drone_routes,
-                                        vehicle_i,
-                                        vehicle_j,
-                                        vehicle_k);
-                                }
-                            }
+                            std::swap(gap, g);
                         }
-                        else
+                    }
+                }
+
+                for (std::size_t i = 1; i + 1 < customers.size(); i++)
+                {
+                    double cost = insertion_cost(route, customer, customers[i - 1], customers[i + 1]);
+                    std::size_t position = i;
+                    for (auto &[gap_cost, gap] : gaps)
+                    {
+                        if (gap != i && gap != i + 1)
                         {
-                            if (vehicle_j < problem->trucks_count)
+                            if (gap_cost < cost)
                             {
-                                if (vehicle_k < problem->trucks_count)
-                                {
-                                    _inter_route_internal<DroneRoute, TruckRoute, TruckRoute>(
-                                        solution,
-                                        aspiration_criteria,
-                                        parent,
-                                        result,
-                                        truck_routes,
-                                        drone_routes,
-                                        vehicle_i,
-                                        vehicle_j,
-                                        vehicle_k);
-                                }
-                                else
-                                {
-                                    _inter_route_internal<DroneRoute, TruckRoute, DroneRoute>(
-                                        solution,
-                                        aspiration_criteria,
-                                        parent,
-                                        result,
-                                        truck_routes,
-                                        drone_routes,
-                                        vehicle_i,
-                                        vehicle_j,
-                                        vehicle_k);
-                                }
+                                cost = gap_cost;
+                                position = gap < i ? gap : gap - 1;
                             }
-                            else
+
+                            break;
+                        }
+                    }
+
+                    callback(customers[i], cost + service, position);
+                }
+            };
+
+            /* The cheapest ways to end a chain at each customer, enough to skip every route of a chain */
+            std::vector<std::vector<_Insertion>> endings(problem->customers.size());
+            for (std::size_t customer = 1; customer < problem->customers.size(); customer++)
+            {
+                auto &options = endings[customer];
+                for (std::size_t route = 0; route < routes.size(); route++)
+                {
+                    if (route != route_of[customer] && !routes[route].redundant)
+                    {
+                        auto insertion = best_insertion(route, customer);
+                        if (insertion.cost < std::numeric_limits<double>::max())
+                        {
+                            options.push_back(insertion);
+                        }
+                    }
+                }
+
+                const auto limit = std::min(options.size(), _max_depth + 1);
+                std::partial_sort(
+                    options.begin(), options.begin() + limit, options.end(),
+                    [](const _Insertion &first, const _Insertion &second)
+                    {
+                        return first.cost < second.cost;
+                    });
+                options.resize(limit);
+            }
+
+            /* Layered dynamic program over chains of increasing depth */
+            std::vector<std::vector<_Label>> labels(_max_depth + 1, std::vector<_Label>(problem->customers.size()));
+            for (std::size_t customer = 1; customer < problem->customers.size(); customer++)
+            {
+                labels[0][customer].cost = -removal_gain[customer];
+            }
+
+            const auto in_chain = [&labels, &route_of](std::size_t depth, std::size_t customer, const std::size_t &route)
+            {
+                while (customer != _npos)
+                {
+                    if (route_of[customer] == route)
+                    {
+                        return true;
+                    }
+
+                    customer = labels[depth--][customer].previous;
+                }
+
+                return false;
+            };
+
+            /* Estimated makespan after a chain, from the working time change of each affected route */
+            const auto makespan = [&](std::size_t depth, std::size_t customer, const _Insertion &end)
+            {
+                std::vector<std::pair<std::size_t, double>> deltas = {{end.route, end.cost}};
+                while (customer != _npos)
+                {
+                    const auto &label = labels[depth][customer];
+                    deltas.emplace_back(route_of[customer], label.previous == _npos ? label.cost : label.cost - labels[depth - 1][label.previous].cost);
+                    customer = label.previous;
+                    depth--;
+                }
+
+                return summaries.makespan(deltas);
+            };
+
+            std::vector<_Chain> chains;
+            for (std::size_t depth = 0; depth < _max_depth; depth++)
+            {
+                for (std::size_t customer = 1; customer < problem->customers.size(); customer++)
+                {
+                    const auto &label = labels[depth][customer];
+                    if (label.cost == std::numeric_limits<double>::max())
+                    {
+                        continue;
+                    }
+
+                    // Only routes passing near the customer are worth inserting into
+                    std::vector<std::size_t> candidate_routes;
+                    for (auto &neighbor : neighbors[customer])
+                    {
+                        const auto &route = route_of[neighbor];
+                        if (std::find(candidate_routes.begin(), candidate_routes.end(), route) == candidate_routes.end() &&
+                            summaries.allowed(route, customer) &&
+                            !in_chain(depth, customer, route))
+                        {
+                            candidate_routes.push_back(route);
+                        }
+                    }
+
+                    for (auto &route : candidate_routes)
+                    {
+                        for_each_ejection(
+                            route, customer,
+                            [&](const std::size_t &ejected, const double &insertion, const std::size_t &position)
                             {
-                                if (vehicle_k < problem->trucks_count)
+                                double cost = label.cost + insertion - removal_gain[ejected];
+                                auto &next_label = labels[depth + 1][ejected];
+                                if (cost < next_label.cost)
                                 {
-                                    _inter_route_internal<DroneRoute, DroneRoute, TruckRoute>(
-                                        solution,
-                                        aspiration_criteria,
-                                        parent,
-                                        result,
-                                        truck_routes,
-                                        drone_routes,
-                                        vehicle_i,
-                                        vehicle_j,
-                                        vehicle_k);
+                                    next_label.cost = cost;
+                                    next_label.previous = customer;
+                                    next_label.position = position;
                                 }
-                                else
-                                {
-                                    _inter_route_internal<DroneRoute, DroneRoute, DroneRoute>(
-                                        solution,
-                                        aspiration_criteria,
-                                        parent,
-                                        result,
-                                        truck_routes,
-                                        drone_routes,
-                                        vehicle_i,
-                                        vehicle_j,
-                                        vehicle_k);
-                                }
-                            }
+                            });
+                    }
+                }
+
+                for (std::size_t customer = 1; customer < problem->customers.size(); customer++)
+                {
+                    const auto &label = labels[depth + 1][customer];
+                    if (label.cost == std::numeric_limits<double>::max())
+                    {
+                        continue;
+                    }
+
+                    for (auto &ending : endings[customer])
+                    {
+                        if (!in_chain(depth + 1, customer, ending.route))
+                        {
+                            chains.push_back({makespan(depth + 1, customer, ending), label.cost + ending.cost, depth + 1, customer, ending});
+                            break;
                         }
                     }
                 }
             }
 
+            /* Evaluate the most promising chains exactly */
+            const auto limit = std::min(chains.size(), problem->customers.size());
+            std::partial_sort(
+                chains.begin(), chains.begin() + limit, chains.end(),
+                [](const _Chain &first, const _Chain &second)
+                {
+                    return std::tie(first.makespan, first.cost) < std::tie(second.makespan, second.cost);
+                });
+
+            auto parent = this->parent_ptr(solution);
+            std::shared_ptr<ST> result;
+
+            ScratchRoutes scratch(solution);
+            for (std::size_t c = 0; c < limit; c++)
+            {
+                const auto &chain = chains[c];
+
+                // Modified customers of each affected route
+                std::vector<RouteSummaries::Modification> modified;
+                std::size_t depth = chain.depth, customer = chain.customer;
+                while (true)
+                {
+                    const auto &label = labels[depth][customer];
+                    const auto &original = *routes[route_of[customer]].customers;
+                    std::vector<std::size_t> customers(original.begin(), original.end());
+                    customers.erase(customers.begin() + position_of[customer]);
+                    if (label.previous != _npos)
+                    {
+                        customers.insert(customers.begin() + label.position, label.previous);
+                    }
+
+                    modified.emplace_back(route_of[customer], std::move(customers));
+                    if (label.previous == _npos)
+                    {
+                        break;
+                    }
+
+                    customer = label.previous;
+                    depth--;
+                }
+
+                if (routes[chain.end.route].customers == nullptr)
+                {
+                    modified.emplace_back(chain.end.route, std::vector<std::size_t>{0, chain.customer, 0});
+                }
+                else
+                {
+                    const auto &original = *routes[chain.end.route].customers;
+                    std::vector<std::size_t> customers(original.begin(), original.end());
+                    customers.insert(customers.begin() + chain.end.position, chain.customer);
+                    modified.emplace_back(chain.end.route, std::move(customers));
+                }
+
+                summaries.apply(modified, scratch);
+                auto new_solution = this->construct(parent, solution, scratch, result);
+                if (new_solution != nullptr && aspiration_criteria(new_solution) && (result == nullptr || new_solution->cost() < result->cost()))
+                {
+                    result = new_solution;
+                }
+
+                scratch.undo();
+            }
+
             return std::make_pair(result, std::vector<std::size_t>());
         }
     };
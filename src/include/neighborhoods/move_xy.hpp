@@ -1,32 +1,102 @@
 #pragma once
 
 #include "abc.hpp"
+#include "batch.hpp"
+#include "scratch.hpp"
 
 namespace d2d
 {
     template <typename ST, std::size_t X, std::size_t Y, std::enable_if_t<(X >= Y && X != 0), bool> = true>
     class _BaseMoveXY : public Neighborhood<ST, true>
     {
+    protected:
+        /** @brief Keys of scans for `_look`. Appending from the route at index `r` of a vehicle uses `_append_look + r`. */
+        static constexpr std::size_t _intra_look = 0, _reversed_intra_look = 1, _inter_look = 2, _append_look = 3;
+
     private:
+        /**
+         * @brief Bound all candidates swapping `[i, i + X)` of `route_i` with `[j, j + Y)` of `route_j`, in the
+         * enumeration order of `_inter_route_internal`.
+         */
         template <typename _RT_I, typename _RT_J, std::enable_if_t<is_route_v<_RT_I, _RT_J>, bool> = true>
+        static MoveBatch<ST> _inter_route_batch(
+            const std::shared_ptr<ST> &solution,
+            const std::size_t &vehicle_i,
+            const std::size_t &route_i,
+            const std::size_t &vehicle_j,
+            const std::size_t &route_j,
+            const RoutePrefix &prefix_i,
+            const RoutePrefix &prefix_j,
+            utils::Arena &arena)
+        {
+            auto problem = Problem::get_instance();
+            const auto &distances = problem->distances;
+
+            const auto &customers_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes, solution->drone_routes)[utils::ternary<std::is_same_v<_RT_I, TruckRoute>>(vehicle_i, vehicle_i - problem->trucks_count)][route_i].customers();
+            const auto &customers_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes, solution->drone_routes)[utils::ternary<std::is_same_v<_RT_J, TruckRoute>>(vehicle_j, vehicle_j - problem->trucks_count)][route_j].customers();
+
+            const auto &service_i = prefix_i.service_time(std::is_same_v<_RT_I, DroneRoute>);
+            const auto &service_j = prefix_j.service_time(std::is_same_v<_RT_J, DroneRoute>);
+            const auto &moved_service_i = prefix_i.service_time(std::is_same_v<_RT_J, DroneRoute>);
+            const auto &moved_service_j = prefix_j.service_time(std::is_same_v<_RT_I, DroneRoute>);
+
+            const auto size_i = customers_i.size(), size_j = customers_j.size();
+
+            MoveBatch<ST> batch(solution, vehicle_i, route_i, vehicle_j, route_j, &arena);
+            for (std::size_t i = 1; i + X < size_i; i++)
+            {
+                for (std::size_t j = 1; j + Y < size_j; j++)
+                {
+                    /* Traveling distance between the neighbors of a segment, through the segment taking its place */
+                    double into_j = distances[customers_j[j - 1]][customers_i[i]] +
+                                    (prefix_i.distance[i + X - 1] - prefix_i.distance[i]) +
+                                    distances[customers_i[i + X - 1]][customers_j[j + Y]];
+                    double into_i = distances[customers_i[i - 1]][customers_i[i + X]];
+                    if constexpr (Y != 0)
+                    {
+                        into_i = distances[customers_i[i - 1]][customers_j[j]] +
+                                 (prefix_j.distance[j + Y - 1] - prefix_j.distance[j]) +
+                                 distances[customers_j[j + Y - 1]][customers_i[i + X]];
+                    }
+
+                    typename MoveBatch<ST>::Route new_i{
+                        prefix_i.distance[i - 1] + into_i + (prefix_i.distance[size_i - 1] - prefix_i.distance[i + X]),
+                        service_i[size_i - 1] - (service_i[i + X] - service_i[i]) + (moved_service_j[j + Y] - moved_service_j[j]),
+                        prefix_i.weight[size_i - 1] - (prefix_i.weight[i + X] - prefix_i.weight[i]) + (prefix_j.weight[j + Y] - prefix_j.weight[j]),
+                        size_i - X + Y,
+                        i};
+                    typename MoveBatch<ST>::Route new_j{
+                        prefix_j.distance[j - 1] + into_j + (prefix_j.distance[size_j - 1] - prefix_j.distance[j + Y]),
+                        service_j[size_j - 1] - (service_j[j + Y] - service_j[j]) + (moved_service_i[i + X] - moved_service_i[i]),
+                        prefix_j.weight[size_j - 1] - (prefix_j.weight[j + Y] - prefix_j.weight[j]) + (prefix_i.weight[i + X] - prefix_i.weight[i]),
+                        size_j - Y + X,
+                        j};
+
+                    batch.push(i, j, new_i, new_j);
+                }
+            }
+
+            batch.evaluate();
+            return batch;
+        }
+
+        template <typename _RT_I, typename _RT_J, typename _AspirationCriteria, std::enable_if_t<is_route_v<_RT_I, _RT_J>, bool> = true>
         void _inter_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AspirationCriteria &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
-            std::vector<std::vector<TruckRoute>> &truck_routes,
-            std::vector<std::vector<DroneRoute>> &drone_routes,
+            ScratchRoutes &scratch,
             const std::size_t &vehicle_i,
             const std::size_t &vehicle_j)
         {
             auto problem = Problem::get_instance();
+            auto &arena = utils::Arena::local();
 
             std::size_t _vehicle_i = utils::ternary<std::is_same_v<_RT_I, TruckRoute>>(vehicle_i, vehicle_i - problem->trucks_count);
             std::size_t _vehicle_j = utils::ternary<std::is_same_v<_RT_J, TruckRoute>>(vehicle_j, vehicle_j - problem->trucks_count);
 
-            auto &vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(truck_routes, drone_routes);
-            auto &vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(truck_routes, drone_routes);
             auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes, solution->drone_routes);
             auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes, solution->drone_routes);
 
@@ -34,37 +104,35 @@ namespace d2d
             {
                 for (std::size_t route_j = 0; route_j < original_vehicle_routes_j[_vehicle_j].size(); route_j++)
                 {
-                    const auto &customers_i = original_vehicle_routes_i[_vehicle_i][route_i].customers();
-                    const auto &customers_j = original_vehicle_routes_j[_vehicle_j][route_j].customers();
-                    for (std::size_t i = 1; i + X < customers_i.size(); i++)
+                    if constexpr (std::is_same_v<_RT_I, _RT_J>)
                     {
-                        for (std::size_t j = 1; j + Y < customers_j.size(); j++)
+                        if (_vehicle_i == _vehicle_j && route_i == route_j) /* same route */
                         {
-                            if constexpr (std::is_same_v<_RT_I, _RT_J>)
-                            {
-                                if (_vehicle_i == _vehicle_j && route_i == route_j) /* same route */
-                                {
-                                    continue;
-                                }
-                            }
-
-                            /* Swap [i, i + X) of route i and [j, j + Y) of route j */
+                            continue;
+                        }
+                    }
 
-                            std::vector<std::size_t> ri(customers_i.begin(), customers_i.begin() + i);
-                            std::vector<std::size_t> rj(customers_j.begin(), customers_j.begin() + j);
+                    if (!original_vehicle_routes_i[_vehicle_i][route_i].geometry().near(original_vehicle_routes_j[_vehicle_j][route_j].geometry()))
+                    {
+                        continue;
+                    }
 
-                            ri.insert(ri.end(), customers_j.begin() + j, customers_j.begin() + (j + Y));
-                            rj.insert(rj.end(), customers_i.begin() + i, customers_i.begin() + (i + X));
+                    const auto &customers_i = original_vehicle_routes_i[_vehicle_i][route_i].customers();
+                    const auto &customers_j = original_vehicle_routes_j[_vehicle_j][route_j].customers();
 
-                            ri.insert(ri.end(), customers_i.begin() + (i + X), customers_i.end());
-                            rj.insert(rj.end(), customers_j.begin() + (j + Y), customers_j.end());
+                    utils::Arena::Scope batch_scope(arena);
+                    const RoutePrefix prefix_i(customers_i, &arena), prefix_j(customers_j, &arena);
+                    const auto batch = _inter_route_batch<_RT_I, _RT_J>(solution, vehicle_i, route_i, vehicle_j, route_j, prefix_i, prefix_j, arena);
 
+                    std::size_t k = 0;
+                    for (std::size_t i = 1; i + X < customers_i.size(); i++)
+                    {
+                        for (std::size_t j = 1; j + Y < customers_j.size(); j++, k++)
+                        {
+                            /* Swap [i, i + X) of route i and [j, j + Y) of route j */
                             if constexpr (std::is_same_v<_RT_I, DroneRoute> && std::is_same_v<_RT_J, TruckRoute>)
                             {
-                                if (std::any_of(
-                                        customers_j.begin() + j, customers_j.begin() + (j + Y),
-                                        [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
+                                if (!prefix_j.dronable(j, j + Y))
                                 {
                                     continue;
                                 }
@@ -72,63 +140,69 @@ namespace d2d
 
                             if constexpr (std::is_same_v<_RT_I, TruckRoute> && std::is_same_v<_RT_J, DroneRoute>)
                             {
-                                if (std::any_of(
-                                        customers_i.begin() + i, customers_i.begin() + (i + X),
-                                        [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
+                                if (!prefix_i.dronable(i, i + X))
                                 {
                                     continue;
                                 }
                             }
 
-                            /* Temporary modify */
-                            bool ri_empty = (ri.size() == 2), rj_empty = (rj.size() == 2); /* Note: At least 1 flag is false */
-                            if (ri_empty)
+                            if (!this->_promising(result, batch.bound(k)))
                             {
-                                vehicle_routes_j[_vehicle_j][route_j] = _RT_J(rj);
-                                vehicle_routes_i[_vehicle_i].erase(vehicle_routes_i[_vehicle_i].begin() + route_i);
+                                continue;
                             }
-                            else if (rj_empty)
+
+                            utils::Arena::Scope scope(arena);
+                            std::pmr::vector<std::size_t> ri(customers_i.begin(), customers_i.begin() + i, &arena);
+                            std::pmr::vector<std::size_t> rj(customers_j.begin(), customers_j.begin() + j, &arena);
+
+                            ri.insert(ri.end(), customers_j.begin() + j, customers_j.begin() + (j + Y));
+                            rj.insert(rj.end(), customers_i.begin() + i, customers_i.begin() + (i + X));
+
+                            ri.insert(ri.end(), customers_i.begin() + (i + X), customers_i.end());
+                            rj.insert(rj.end(), customers_j.begin() + (j + Y), customers_j.end());
+
+                            /* Temporary modify */
+                            /* Note: At least 1 route is not empty. Erasing an emptied route last keeps the other index valid */
+                            if (ri.size() == 2)
                             {
-                                vehicle_routes_i[_vehicle_i][route_i] = _RT_I(ri);
-                                vehicle_routes_j[_vehicle_j].erase(vehicle_routes_j[_vehicle_j].begin() + route_j);
+                                scratch.assign<_RT_J>(_vehicle_j, route_j, rj);
+                                scratch.assign<_RT_I>(_vehicle_i, route_i, ri);
                             }
                             else
                             {
-                                vehicle_routes_i[_vehicle_i][route_i] = _RT_I(ri);
-                                vehicle_routes_j[_vehicle_j][route_j] = _RT_J(rj);
+                                scratch.assign<_RT_I>(_vehicle_i, route_i, ri);
+                                scratch.assign<_RT_J>(_vehicle_j, route_j, rj);
                             }
 
-                            std::vector<std::size_t> new_tabu(customers_i.begin() + i, customers_i.begin() + (i + X));
+                            std::pmr::vector<std::size_t> new_tabu(customers_i.begin() + i, customers_i.begin() + (i + X), &arena);
                             new_tabu.insert(new_tabu.end(), customers_j.begin() + j, customers_j.begin() + (j + Y));
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
+                            auto new_solution = this->construct(parent, solution, scratch, result);
+                            if (new_solution != nullptr &&
+                                solution->cost() != new_solution->cost() &&
                                 (aspiration_criteria(new_solution) || !this->is_tabu(new_tabu)) &&
                                 (result == nullptr || new_solution->cost() < result->cost()))
                             {
                                 result = new_solution;
-                                tabu = new_tabu;
+                                tabu.assign(new_tabu.begin(), new_tabu.end());
                             }
 
                             /* Restore */
-                            vehicle_routes_i[_vehicle_i] = original_vehicle_routes_i[_vehicle_i];
-                            vehicle_routes_j[_vehicle_j] = original_vehicle_routes_j[_vehicle_j];
+                            scratch.undo();
                         }
                     }
                 }
             }
         }
 
-        template <typename _RT_Src, std::enable_if_t<is_route_v<_RT_Src>, bool> = true>
+        template <typename _RT_Src, typename _AspirationCriteria, std::enable_if_t<is_route_v<_RT_Src>, bool> = true>
         void _inter_route_append_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AspirationCriteria &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
-            std::vector<std::vector<TruckRoute>> &truck_routes,
-            std::vector<std::vector<DroneRoute>> &drone_routes)
+            ScratchRoutes &scratch)
         {
             if constexpr (X != 0 && Y != 0)
             {
@@ -138,39 +212,47 @@ namespace d2d
             constexpr std::size_t Z = X + Y;
 
             auto problem = Problem::get_instance();
+            auto &arena = utils::Arena::local();
 
-            auto &vehicle_routes_src = utils::match_type<std::vector<std::vector<_RT_Src>>>(truck_routes, drone_routes);
             auto &original_vehicle_routes_src = utils::match_type<std::vector<std::vector<_RT_Src>>>(solution->truck_routes, solution->drone_routes);
+            const auto redundant = this->_redundant_vehicles(solution);
 
             for (std::size_t vehicle_src = 0; vehicle_src < original_vehicle_routes_src.size(); vehicle_src++)
             {
                 for (std::size_t route_src = 0; route_src < original_vehicle_routes_src[vehicle_src].size(); route_src++)
                 {
+                    const auto &customers = original_vehicle_routes_src[vehicle_src][route_src].customers();
+
+                    utils::Arena::Scope route_scope(arena);
+                    const RoutePrefix prefix(customers, &arena);
+
                     for (std::size_t vehicle_dest = 0; vehicle_dest < problem->trucks_count + problem->drones_count; vehicle_dest++)
                     {
-                        const auto &customers = original_vehicle_routes_src[vehicle_src][route_src].customers();
+                        const auto vehicle = utils::ternary<std::is_same_v<_RT_Src, TruckRoute>>(vehicle_src, problem->trucks_count + vehicle_src);
+                        if (redundant[vehicle_dest] || !this->_look(solution, result, _append_look + route_src, vehicle, vehicle_dest))
+                        {
+                            continue;
+                        }
+
                         for (std::size_t i = 1; i + Z < customers.size(); i++)
                         {
                             /* Append [i, i + Z) from route_src to vehicle_dest */
-                            std::vector<std::size_t> new_customers(customers.begin(), customers.begin() + i);
-                            new_customers.insert(new_customers.end(), customers.begin() + (i + Z), customers.end());
-
-                            std::vector<std::size_t> detached = {0};
-                            detached.insert(detached.end(), customers.begin() + i, customers.begin() + (i + Z));
-                            detached.push_back(0);
-
                             if constexpr (std::is_same_v<_RT_Src, TruckRoute>)
                             {
-                                if (vehicle_dest >= problem->trucks_count &&
-                                    std::any_of(
-                                        detached.begin() + 1, detached.end() - 1, /* excluding depot */
-                                        [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
+                                if (vehicle_dest >= problem->trucks_count && !prefix.dronable(i, i + Z))
                                 {
                                     continue;
                                 }
                             }
 
+                            utils::Arena::Scope scope(arena);
+                            std::pmr::vector<std::size_t> new_customers(customers.begin(), customers.begin() + i, &arena);
+                            new_customers.insert(new_customers.end(), customers.begin() + (i + Z), customers.end());
+
+                            std::pmr::vector<std::size_t> detached(1, 0, &arena);
+                            detached.insert(detached.end(), customers.begin() + i, customers.begin() + (i + Z));
+                            detached.push_back(0);
+
                             /* Temporary modify */
                             if (new_customers.size() == 2) // route_src is now empty, check for no-op moves
                             {
@@ -190,54 +272,40 @@ namespace d2d
                                         continue;
                                     }
                                 }
-
-                                vehicle_routes_src[vehicle_src].erase(vehicle_routes_src[vehicle_src].begin() + route_src);
                             }
-                            else
+
+                            if (!this->_promising(result))
                             {
-                                vehicle_routes_src[vehicle_src][route_src] = _RT_Src(new_customers);
+                                continue;
                             }
 
+                            scratch.assign<_RT_Src>(vehicle_src, route_src, new_customers);
                             if (vehicle_dest < problem->trucks_count)
                             {
-                                truck_routes[vehicle_dest].push_back(TruckRoute(detached));
+                                scratch.append<TruckRoute>(vehicle_dest, detached);
                             }
                             else
                             {
-                                drone_routes[vehicle_dest - problem->trucks_count].push_back(DroneRoute(detached));
+                                scratch.append<DroneRoute>(vehicle_dest - problem->trucks_count, detached);
                             }
 
-                            std::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + Z));
+                            std::pmr::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + Z), &arena);
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
+                            auto new_solution = this->construct(parent, solution, scratch, result);
+                            if (new_solution != nullptr &&
+                                solution->cost() != new_solution->cost() &&
                                 (aspiration_criteria(new_solution) || !this->is_tabu(new_tabu)) &&
                                 (result == nullptr || new_solution->cost() < result->cost()))
                             {
                                 result = new_solution;
-                                tabu = new_tabu;
+                                tabu.assign(new_tabu.begin(), new_tabu.end());
                             }
 
                             /* Restore */
-                            if (new_customers.size() == 2)
-                            {
-                                vehicle_routes_src[vehicle_src].insert(
-                                    vehicle_routes_src[vehicle_src].begin() + route_src,
-                                    original_vehicle_routes_src[vehicle_src][route_src]);
-                            }
-                            else
-                            {
-                                vehicle_routes_src[vehicle_src][route_src] = original_vehicle_routes_src[vehicle_src][route_src];
-                            }
-                            if (vehicle_dest < problem->trucks_count)
-                            {
-                                truck_routes[vehicle_dest].pop_back();
-                            }
-                            else
-                            {
-                                drone_routes[vehicle_dest - problem->trucks_count].pop_back();
-                            }
+                            scratch.undo();
                         }
+
+                        this->_looked();
                     }
                 }
             }
@@ -249,9 +317,10 @@ namespace d2d
             return utils::format("Move (%d, %d)", X, Y);
         }
 
+        template <typename _AspirationCriteria>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AspirationCriteria &aspiration_criteria)
         {
             auto problem = Problem::get_instance();
             auto parent = this->parent_ptr(solution);
@@ -259,42 +328,49 @@ namespace d2d
             std::shared_ptr<ST> result;
             std::vector<std::size_t> tabu;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            ScratchRoutes scratch(solution);
 
             for (std::size_t vehicle_i = 0; vehicle_i < problem->trucks_count + problem->drones_count; vehicle_i++)
             {
                 for (std::size_t vehicle_j = (X == Y ? vehicle_i : 0); vehicle_j < problem->trucks_count + problem->drones_count; vehicle_j++)
                 {
+                    if (this->_no_route_pairs(solution, vehicle_i, vehicle_j) ||
+                        !this->_look(solution, result, _inter_look, vehicle_i, vehicle_j))
+                    {
+                        continue;
+                    }
+
                     if (vehicle_i < problem->trucks_count)
                     {
                         if (vehicle_j < problem->trucks_count)
                         {
-                            _inter_route_internal<TruckRoute, TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
+                            _inter_route_internal<TruckRoute, TruckRoute>(solution, aspiration_criteria, parent, result, tabu, scratch, vehicle_i, vehicle_j);
                         }
                         else
                         {
-                            _inter_route_internal<TruckRoute, DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
+                            _inter_route_internal<TruckRoute, DroneRoute>(solution, aspiration_criteria, parent, result, tabu, scratch, vehicle_i, vehicle_j);
                         }
                     }
                     else
                     {
                         if (vehicle_j < problem->trucks_count)
                         {
-                            _inter_route_internal<DroneRoute, TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
+                            _inter_route_internal<DroneRoute, TruckRoute>(solution, aspiration_criteria, parent, result, tabu, scratch, vehicle_i, vehicle_j);
                         }
                         else
                         {
-                            _inter_route_internal<DroneRoute, DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, vehicle_i, vehicle_j);
+                            _inter_route_internal<DroneRoute, DroneRoute>(solution, aspiration_criteria, parent, result, tabu, scratch, vehicle_i, vehicle_j);
                         }
                     }
+
+                    this->_looked();
                 }
             }
 
             if constexpr (X == 0 || Y == 0)
             {
-                _inter_route_append_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes);
-                _inter_route_append_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes);
+                _inter_route_append_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, scratch);
+                _inter_route_append_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, scratch);
             }
 
             return std::make_pair(result, tabu);
@@ -305,26 +381,32 @@ namespace d2d
     class MoveXY : public _BaseMoveXY<ST, X, Y>
     {
     private:
-        template <typename _RT, std::enable_if_t<is_route_v<_RT>, bool> = true>
+        template <typename _RT, typename _AspirationCriteria, std::enable_if_t<is_route_v<_RT>, bool> = true>
         void _intra_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AspirationCriteria &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
-            std::vector<std::vector<TruckRoute>> &truck_routes,
-            std::vector<std::vector<DroneRoute>> &drone_routes,
+            ScratchRoutes &scratch,
             const std::size_t &_X,
             const std::size_t &_Y)
         {
             auto problem = Problem::get_instance();
+            auto &arena = utils::Arena::local();
+            const auto look = _X == X ? this->_intra_look : this->_reversed_intra_look;
 
             auto vehicles_count = utils::ternary<std::is_same_v<_RT, TruckRoute>>(problem->trucks_count, problem->drones_count);
-            auto &vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(truck_routes, drone_routes);
             auto &original_vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(solution->truck_routes, solution->drone_routes);
 
             for (std::size_t index = 0; index < vehicles_count; index++)
             {
+                const auto vehicle = utils::ternary<std::is_same_v<_RT, TruckRoute>>(index, problem->trucks_count + index);
+                if (!this->_look(solution, result, look, vehicle, vehicle))
+                {
+                    continue;
+                }
+
                 for (std::size_t route = 0; route < original_vehicle_routes[index].size(); route++)
                 {
                     const auto &customers = original_vehicle_routes[index][route].customers();
@@ -332,8 +414,14 @@ namespace d2d
                     {
                         for (std::size_t j = i + _X; j + _Y < customers.size(); j++)
                         {
+                            if (!this->_promising(result))
+                            {
+                                continue;
+                            }
+
                             /* Swap [i, i + _X) and [j, j + _Y) */
-                            std::vector<std::size_t> new_customers(customers);
+                            utils::Arena::Scope scope(arena);
+                            std::pmr::vector<std::size_t> new_customers(customers.begin(), customers.end(), &arena);
                             if (_X > _Y)
                             {
                                 std::swap_ranges(new_customers.begin() + i, new_customers.begin() + i + _Y, new_customers.begin() + j);
@@ -346,47 +434,50 @@ namespace d2d
                             }
 
                             /* Temporary modify */
-                            vehicle_routes[index][route] = _RT(new_customers);
+                            scratch.replace<_RT>(index, route, new_customers);
 
-                            std::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + _X));
+                            std::pmr::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + _X), &arena);
                             new_tabu.insert(new_tabu.end(), customers.begin() + j, customers.begin() + (j + _Y));
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
+                            auto new_solution = this->construct(parent, solution, scratch, result);
+                            if (new_solution != nullptr &&
+                                solution->cost() != new_solution->cost() &&
                                 (aspiration_criteria(new_solution) || !this->is_tabu(new_tabu)) &&
                                 (result == nullptr || new_solution->cost() < result->cost()))
                             {
                                 result = new_solution;
-                                tabu = new_tabu;
+                                tabu.assign(new_tabu.begin(), new_tabu.end());
                             }
 
                             /* Restore */
-                            vehicle_routes[index][route] = original_vehicle_routes[index][route];
+                            scratch.undo();
                         }
                     }
                 }
+
+                this->_looked();
             }
         }
 
-    protected:
+    public:
+        template <typename _AspirationCriteria>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AspirationCriteria &aspiration_criteria)
         {
             auto parent = this->parent_ptr(solution);
 
             std::shared_ptr<ST> result;
             std::vector<std::size_t> tabu;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            ScratchRoutes scratch(solution);
 
-            _intra_route_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, X, Y);
-            _intra_route_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, X, Y);
+            _intra_route_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, scratch, X, Y);
+            _intra_route_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, scratch, X, Y);
             if constexpr (X != Y)
             {
-                _intra_route_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, Y, X);
-                _intra_route_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes, Y, X);
+                _intra_route_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, scratch, Y, X);
+                _intra_route_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, scratch, Y, X);
             }
 
             return std::make_pair(result, tabu);
@@ -397,24 +488,29 @@ namespace d2d
     class MoveXY<ST, X, 0> : public _BaseMoveXY<ST, X, 0>
     {
     private:
-        template <typename _RT, std::enable_if_t<is_route_v<_RT>, bool> = true>
+        template <typename _RT, typename _AspirationCriteria, std::enable_if_t<is_route_v<_RT>, bool> = true>
         void _intra_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AspirationCriteria &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
-            std::vector<std::vector<TruckRoute>> &truck_routes,
-            std::vector<std::vector<DroneRoute>> &drone_routes)
+            ScratchRoutes &scratch)
         {
             auto problem = Problem::get_instance();
+            auto &arena = utils::Arena::local();
 
             auto vehicles_count = utils::ternary<std::is_same_v<_RT, TruckRoute>>(problem->trucks_count, problem->drones_count);
-            auto &vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(truck_routes, drone_routes);
             auto &original_vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(solution->truck_routes, solution->drone_routes);
 
             for (std::size_t index = 0; index < vehicles_count; index++)
             {
+                const auto vehicle = utils::ternary<std::is_same_v<_RT, TruckRoute>>(index, problem->trucks_count + index);
+                if (!this->_look(solution, result, this->_intra_look, vehicle, vehicle))
+                {
+                    continue;
+                }
+
                 for (std::size_t route = 0; route < original_vehicle_routes[index].size(); route++)
                 {
                     const auto &customers = original_vehicle_routes[index][route].customers();
@@ -422,69 +518,85 @@ namespace d2d
                     {
                         for (std::size_t j = 1; j < i; j++)
                         {
+                            if (!this->_promising(result))
+                            {
+                                continue;
+                            }
+
                             /* Move [i, i + X) to position j (customers[j] = customers[i]) */
-                            std::vector<std::size_t> new_customers(customers);
+                            utils::Arena::Scope scope(arena);
+                            std::pmr::vector<std::size_t> new_customers(customers.begin(), customers.end(), &arena);
                             std::rotate(new_customers.begin() + j, new_customers.begin() + i, new_customers.begin() + (i + X));
 
-                            vehicle_routes[index][route] = _RT(new_customers);
+                            scratch.replace<_RT>(index, route, new_customers);
 
-                            std::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + X));
+                            std::pmr::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + X), &arena);
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
+                            auto new_solution = this->construct(parent, solution, scratch, result);
+                            if (new_solution != nullptr &&
+                                solution->cost() != new_solution->cost() &&
                                 (aspiration_criteria(new_solution) || !this->is_tabu(new_tabu)) &&
                                 (result == nullptr || new_solution->cost() < result->cost()))
                             {
                                 result = new_solution;
-                                tabu = new_tabu;
+                                tabu.assign(new_tabu.begin(), new_tabu.end());
                             }
 
                             /* Restore */
-                            vehicle_routes[index][route] = original_vehicle_routes[index][route];
+                            scratch.undo();
                         }
 
                         for (std::size_t j = i + X; j + 1 < customers.size(); j++)
                         {
+                            if (!this->_promising(result))
+                            {
+                                continue;
+                            }
+
                             /* Move [i, i + X) to position j (customers[j] = customers[i]) */
-                            std::vector<std::size_t> new_customers(customers);
+                            utils::Arena::Scope scope(arena);
+                            std::pmr::vector<std::size_t> new_customers(customers.begin(), customers.end(), &arena);
                             std::rotate(new_customers.begin() + i, new_customers.begin() + (i + X), new_customers.begin() + (j + 1));
 
-                            vehicle_routes[index][route] = _RT(new_customers);
+                            scratch.replace<_RT>(index, route, new_customers);
 
-                            std::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + X));
+                            std::pmr::vector<std::size_t> new_tabu(customers.begin() + i, customers.begin() + (i + X), &arena);
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
+                            auto new_solution = this->construct(parent, solution, scratch, result);
+                            if (new_solution != nullptr &&
+                                solution->cost() != new_solution->cost() &&
                                 (aspiration_criteria(new_solution) || !this->is_tabu(new_tabu)) &&
                                 (result == nullptr || new_solution->cost() < result->cost()))
                             {
                                 result = new_solution;
-                                tabu = new_tabu;
+                                tabu.assign(new_tabu.begin(), new_tabu.end());
                             }
 
                             /* Restore */
-                            vehicle_routes[index][route] = original_vehicle_routes[index][route];
+                            scratch.undo();
                         }
                     }
                 }
+
+                this->_looked();
             }
         }
 
-    protected:
+    public:
+        template <typename _AspirationCriteria>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AspirationCriteria &aspiration_criteria)
         {
             auto parent = this->parent_ptr(solution);
 
             std::shared_ptr<ST> result;
             std::vector<std::size_t> tabu;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            ScratchRoutes scratch(solution);
 
-            _intra_route_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes);
-            _intra_route_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes);
+            _intra_route_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, scratch);
+            _intra_route_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, scratch);
 
             return std::make_pair(result, tabu);
         }
@@ -0,0 +1,279 @@
+#pragma once
+
+#include "abc.hpp"
+
+namespace d2d
+{
+    /**
+     * @brief Reassign whole routes among vehicles of the same kind to balance their working times.
+     *
+     * The working time of a drone is the sum of the working times of its routes, so assigning drone routes to drones
+     * is scheduling on identical machines (P||Cmax). Routes are first assigned by the longest-processing-time rule,
+     * then by a depth-first branch-and-bound over routes in decreasing order of working time, which stops after
+     * `_max_nodes` nodes. Truck working times depend on the time of day each route starts, so truck routes are
+     * rebalanced by a descent moving or swapping routes of the most loaded truck, evaluating both trucks exactly.
+     */
+    template <typename ST>
+    class TripReassignment : public Neighborhood<ST, false>
+    {
+    private:
+        static constexpr std::size_t _max_nodes = 100000;
+
+        struct _Trip
+        {
+            double working_time;
+            std::size_t drone, index;
+        };
+
+        class _Balancer
+        {
+        private:
+            const std::vector<_Trip> &_trips;
+            std::vector<double> _loads;
+            std::vector<std::size_t> _assignment;
+            std::size_t _nodes = 0;
+
+            void _search(const std::size_t &k)
+            {
+                if (k == _trips.size())
+                {
+                    makespan = *std::max_element(_loads.begin(), _loads.end());
+                    best = _assignment;
+                    return;
+                }
+
+                for (std::size_t machine = 0; machine < _loads.size() && _nodes < _max_nodes && makespan > lower_bound; machine++)
+                {
+                    // Machines with equal loads lead to symmetric subtrees
+                    if (std::find(_loads.begin(), _loads.begin() + machine, _loads[machine]) != _loads.begin() + machine ||
+                        _loads[machine] + _trips[k].working_time >= makespan - TOLERANCE)
+                    {
+                        continue;
+                    }
+
+                    _nodes++;
+                    _loads[machine] += _trips[k].working_time;
+                    _assignment[k] = machine;
+                    _search(k + 1);
+                    _loads[machine] -= _trips[k].working_time;
+                }
+            }
+
+        public:
+            double lower_bound, makespan;
+            std::vector<std::size_t> best;
+
+            /** @brief Assign `trips`, sorted in decreasing order of working time, to `machines` machines. */
+            _Balancer(const std::vector<_Trip> &trips, const std::size_t &machines)
+                : _trips(trips), _loads(machines), _assignment(trips.size()), best(trips.size())
+            {
+                double total = 0;
+                for (std::size_t k = 0; k < trips.size(); k++)
+                {
+                    auto machine = std::min_element(_loads.begin(), _loads.end()) - _loads.begin();
+                    _loads[machine] += trips[k].working_time;
+                    best[k] = machine;
+                    total += trips[k].working_time;
+                }
+
+                makespan = *std::max_element(_loads.begin(), _loads.end());
+                lower_bound = std::max(total / machines, trips.empty() ? 0.0 : trips.front().working_time) + TOLERANCE;
+
+                std::fill(_loads.begin(), _loads.end(), 0.0);
+                _search(0);
+            }
+        };
+
+        /** @brief The working time and waiting time violation of a truck serving `routes` in order. */
+        static std::pair<double, double> _evaluate_truck(const std::vector<TruckRoute> &routes)
+        {
+            std::size_t coefficients_index = 0;
+            double current_within_timespan = 0, working_time = 0, waiting_time_violation = 0;
+            for (auto &route : routes)
+            {
+                working_time += TruckRoute::calculate_working_time(route.customers(), coefficients_index, current_within_timespan, waiting_time_violation);
+            }
+
+            return std::make_pair(working_time, waiting_time_violation);
+        }
+
+        /** @return Whether the drone routes were rebalanced. */
+        static bool _balance_drones(const std::shared_ptr<ST> &solution, std::vector<std::vector<DroneRoute>> &drone_routes)
+        {
+            if (drone_routes.size() < 2)
+            {
+                return false;
+            }
+
+            std::vector<_Trip> trips;
+            for (std::size_t drone = 0; drone < drone_routes.size(); drone++)
+            {
+                for (std::size_t index = 0; index < drone_routes[drone].size(); index++)
+                {
+                    trips.push_back({drone_routes[drone][index].working_time(), drone, index});
+                }
+            }
+
+            std::stable_sort(
+                trips.begin(), trips.end(),
+                [](const _Trip &first, const _Trip &second)
+                { return first.working_time > second.working_time; });
+
+            const _Balancer balancer(trips, drone_routes.size());
+            const double current = *std::max_element(solution->drone_working_time.begin(), solution->drone_working_time.end());
+            if (balancer.makespan >= current - TOLERANCE)
+            {
+                return false;
+            }
+
+            // Keep the original relative order of routes assigned to the same drone
+            std::vector<std::size_t> order(trips.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(
+                order.begin(), order.end(),
+                [&trips](const std::size_t &first, const std::size_t &second)
+                { return std::make_pair(trips[first].drone, trips[first].index) < std::make_pair(trips[second].drone, trips[second].index); });
+
+            std::vector<std::vector<DroneRoute>> balanced(drone_routes.size());
+            for (auto &k : order)
+            {
+                balanced[balancer.best[k]].push_back(drone_routes[trips[k].drone][trips[k].index]);
+            }
+
+            drone_routes = std::move(balanced);
+            return true;
+        }
+
+        /** @return Whether the truck routes were rebalanced. */
+        static bool _balance_trucks(std::vector<std::vector<TruckRoute>> &truck_routes)
+        {
+            if (truck_routes.size() < 2)
+            {
+                return false;
+            }
+
+            std::vector<std::pair<double, double>> evaluations;
+            for (auto &routes : truck_routes)
+            {
+                evaluations.push_back(_evaluate_truck(routes));
+            }
+
+            std::size_t total_routes = 0;
+            for (auto &routes : truck_routes)
+            {
+                total_routes += routes.size();
+            }
+
+            bool balanced = false;
+            for (std::size_t step = 0; step < total_routes; step++)
+            {
+                const std::size_t busiest = std::max_element(
+                                                evaluations.begin(), evaluations.end(),
+                                                [](const std::pair<double, double> &first, const std::pair<double, double> &second)
+                                                { return first.first < second.first; }) -
+                                            evaluations.begin();
+
+                double best_makespan = evaluations[busiest].first - TOLERANCE;
+                std::vector<TruckRoute> best_from, best_to;
+                std::pair<double, double> best_from_evaluation, best_to_evaluation;
+                std::size_t best_truck = truck_routes.size();
+
+                const auto consider = [&](const std::size_t &truck, std::vector<TruckRoute> &from, std::vector<TruckRoute> &to)
+                {
+                    const auto from_evaluation = _evaluate_truck(from), to_evaluation = _evaluate_truck(to);
+                    const double makespan = std::max(from_evaluation.first, to_evaluation.first);
+                    if (makespan < best_makespan &&
+                        from_evaluation.second + to_evaluation.second <= evaluations[busiest].second + evaluations[truck].second + TOLERANCE)
+                    {
+                        best_makespan = makespan;
+                        best_from = from;
+                        best_to = to;
+                        best_from_evaluation = from_evaluation;
+                        best_to_evaluation = to_evaluation;
+                        best_truck = truck;
+                    }
+                };
+
+                bool empty_tried = false;
+                for (std::size_t truck = 0; truck < truck_routes.size(); truck++)
+                {
+                    if (truck == busiest || (truck_routes[truck].empty() && empty_tried))
+                    {
+                        continue;
+                    }
+
+                    empty_tried |= truck_routes[truck].empty();
+                    for (std::size_t i = 0; i < truck_routes[busiest].size(); i++)
+                    {
+                        // Move route i to the end of the other truck
+                        auto from = truck_routes[busiest], to = truck_routes[truck];
+                        to.push_back(from[i]);
+                        from.erase(from.begin() + i);
+                        consider(truck, from, to);
+
+                        // Swap route i with each route of the other truck
+                        for (std::size_t j = 0; j < truck_routes[truck].size(); j++)
+                        {
+                            from = truck_routes[busiest];
+                            to = truck_routes[truck];
+                            std::swap(from[i], to[j]);
+                            consider(truck, from, to);
+                        }
+                    }
+                }
+
+                if (best_truck == truck_routes.size())
+                {
+                    break;
+                }
+
+                truck_routes[busiest] = std::move(best_from);
+                truck_routes[best_truck] = std::move(best_to);
+                evaluations[busiest] = best_from_evaluation;
+                evaluations[best_truck] = best_to_evaluation;
+                balanced = true;
+            }
+
+            return balanced;
+        }
+
+    public:
+        std::string label() const override
+        {
+            return "Trip reassignment";
+        }
+
+        template <typename _AspirationCriteria>
+        std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
+            const std::shared_ptr<ST> solution,
+            const _AspirationCriteria &aspiration_criteria)
+        {
+            return std::make_pair(nullptr, std::vector<std::size_t>());
+        }
+
+        template <typename _AspirationCriteria>
+        std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
+            const std::shared_ptr<ST> solution,
+            const _AspirationCriteria &aspiration_criteria)
+        {
+            auto truck_routes = solution->truck_routes;
+            auto drone_routes = solution->drone_routes;
+
+            const bool drones = _balance_drones(solution, drone_routes);
+            const bool trucks = _balance_trucks(truck_routes);
+            if (!drones && !trucks)
+            {
+                return std::make_pair(nullptr, std::vector<std::size_t>());
+            }
+
+            auto new_solution = this->construct(this->parent_ptr(solution), truck_routes, drone_routes);
+            if (new_solution->cost() < solution->cost())
+            {
+                aspiration_criteria(new_solution);
+                return std::make_pair(new_solution, std::vector<std::size_t>());
+            }
+
+            return std::make_pair(nullptr, std::vector<std::size_t>());
+        }
+    };
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "../trips.hpp"
+
+namespace d2d
+{
+    /**
+     * @brief A mutable copy of the routes of a solution, for neighborhoods to try moves in place.
+     *
+     * Every modification records the route it overwrites in an undo log, so that `undo` restores the original
+     * routes by moving them back instead of copying whole vehicles. Route objects are only ever moved, never
+     * copied, after construction, except for short drone routes copied from `DroneTrips`.
+     */
+    class ScratchRoutes
+    {
+    private:
+        template <typename RT>
+        struct _Change
+        {
+            std::size_t vehicle, index;
+
+            /** @brief The overwritten route, or `std::nullopt` if this change appended a new route. */
+            std::optional<RT> route;
+
+            /** @brief Whether the route at `index` was removed. */
+            bool erased;
+        };
+
+        std::vector<_Change<TruckRoute>> _truck_log;
+        std::vector<_Change<DroneRoute>> _drone_log;
+
+        template <typename RT>
+        std::vector<_Change<RT>> &_log()
+        {
+            return utils::match_type<std::vector<_Change<RT>>>(_truck_log, _drone_log);
+        }
+
+        template <typename RT>
+        const std::vector<_Change<RT>> &_log() const
+        {
+            return utils::match_type<std::vector<_Change<RT>>>(_truck_log, _drone_log);
+        }
+
+        template <typename RT>
+        void _undo()
+        {
+            auto &log = _log<RT>();
+            auto &vehicle_routes = routes<RT>();
+            for (auto change = log.rbegin(); change != log.rend(); change++)
+            {
+                auto &routes = vehicle_routes[change->vehicle];
+                if (!change->route.has_value())
+                {
+                    routes.pop_back();
+                }
+                else if (change->erased)
+                {
+                    routes.insert(routes.begin() + change->index, std::move(*change->route));
+                }
+                else
+                {
+                    routes[change->index] = std::move(*change->route);
+                }
+            }
+
+            log.clear();
+        }
+
+        /** @brief A route visiting `customers`, copied from `DroneTrips` when possible. */
+        template <typename RT, typename _Alloc>
+        static RT _route(const std::vector<std::size_t, _Alloc> &customers)
+        {
+            if constexpr (std::is_same_v<RT, DroneRoute>)
+            {
+                auto trip = DroneTrips::get_instance().find(customers);
+                if (trip != nullptr)
+                {
+                    return *trip;
+                }
+            }
+
+            return RT(customers);
+        }
+
+    public:
+        std::vector<std::vector<TruckRoute>> truck_routes;
+        std::vector<std::vector<DroneRoute>> drone_routes;
+
+        template <typename ST>
+        explicit ScratchRoutes(const std::shared_ptr<ST> &solution)
+            : truck_routes(solution->truck_routes), drone_routes(solution->drone_routes) {}
+
+        template <typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>
+        std::vector<std::vector<RT>> &routes()
+        {
+            return utils::match_type<std::vector<std::vector<RT>>>(truck_routes, drone_routes);
+        }
+
+        /** @brief Replace the route at `index` of `vehicle` with a route visiting `customers`. */
+        template <typename RT, typename _Alloc, std::enable_if_t<is_route_v<RT>, bool> = true>
+        void replace(const std::size_t &vehicle, const std::size_t &index, const std::vector<std::size_t, _Alloc> &customers)
+        {
+            auto &route = routes<RT>()[vehicle][index];
+            _log<RT>().push_back({vehicle, index, std::move(route), false});
+            route = _route<RT>(customers);
+        }
+
+        /** @brief Remove the route at `index` of `vehicle`. */
+        template <typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>
+        void erase(const std::size_t &vehicle, const std::size_t &index)
+        {
+            auto &vehicle_routes = routes<RT>()[vehicle];
+            _log<RT>().push_back({vehicle, index, std::move(vehicle_routes[index]), true});
+            vehicle_routes.erase(vehicle_routes.begin() + index);
+        }
+
+        /** @brief Add a new route visiting `customers` to `vehicle`. */
+        template <typename RT, typename _Alloc, std::enable_if_t<is_route_v<RT>, bool> = true>
+        void append(const std::size_t &vehicle, const std::vector<std::size_t, _Alloc> &customers)
+        {
+            auto &vehicle_routes = routes<RT>()[vehicle];
+            _log<RT>().push_back({vehicle, vehicle_routes.size(), std::nullopt, false});
+            vehicle_routes.push_back(_route<RT>(customers));
+        }
+
+        /**
+         * @brief Set the customers of the route at `index` of `vehicle`: a route left with no customers is
+         * removed, and an index past the last route appends a new one.
+         */
+        template <typename RT, typename _Alloc, std::enable_if_t<is_route_v<RT>, bool> = true>
+        void assign(const std::size_t &vehicle, const std::size_t &index, const std::vector<std::size_t, _Alloc> &customers)
+        {
+            if (index == routes<RT>()[vehicle].size())
+            {
+                append<RT>(vehicle, customers);
+            }
+            else if (customers.size() == 2)
+            {
+                erase<RT>(vehicle, index);
+            }
+            else
+            {
+                replace<RT>(vehicle, index, customers);
+            }
+        }
+
+        /** @brief Whether a route of `vehicle` was modified since construction or the last call to `undo`. */
+        template <typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>
+        bool modified(const std::size_t &vehicle) const
+        {
+            const auto &log = _log<RT>();
+            return std::any_of(
+                log.begin(), log.end(),
+                [&vehicle](const _Change<RT> &change)
+                { return change.vehicle == vehicle; });
+        }
+
+        /** @brief Revert all modifications since construction or the last call to `undo`. */
+        void undo()
+        {
+            _undo<TruckRoute>();
+            _undo<DroneRoute>();
+        }
+    };
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "abc.hpp"
+#include "scratch.hpp"
+
+namespace d2d
+{
+    /**
+     * @brief A flat view over all routes of a solution, for neighborhoods that estimate moves from route
+     * summaries before constructing solutions.
+     *
+     * Routes of all trucks come first, followed by routes of all drones. After the routes of each vehicle, an
+     * extra slot stands for a new route of that vehicle.
+     */
+    class RouteSummaries
+    {
+    public:
+        struct Route
+        {
+            bool drone;
+            std::size_t vehicle, index;
+
+            /** @brief Index of the vehicle among all trucks and drones. */
+            std::size_t global_vehicle;
+
+            /** @brief Traveling time per unit of distance. */
+            double time_factor;
+
+            /** @brief The customers of this route, or `nullptr` for the slot of a new route. */
+            const RouteCustomers *customers;
+
+            /** @brief The spatial extent of this route, or `nullptr` for the slot of a new route. */
+            const RouteGeometry *geometry;
+
+            /**
+             * @brief Whether this is the slot of a new route of an empty vehicle, while an earlier vehicle of the
+             * same type is empty too. Inserting into this slot is symmetric to inserting into the earlier one.
+             */
+            bool redundant;
+        };
+
+        /**
+         * @brief Customers of a route after a move, paired with the route index. A route left with no customers
+         * is removed.
+         */
+        using Modification = std::pair<std::size_t, std::vector<std::size_t>>;
+
+        std::vector<Route> routes;
+
+        /** @brief The route index and the position in that route of each customer. */
+        std::vector<std::size_t> route_of, position_of;
+
+        /** @brief Working time of each vehicle, indexed by `Route::global_vehicle`. */
+        std::vector<double> working_time;
+
+        template <typename ST>
+        explicit RouteSummaries(const std::shared_ptr<ST> &solution)
+            : route_of(Problem::get_instance()->customers.size(), std::numeric_limits<std::size_t>::max()),
+              position_of(Problem::get_instance()->customers.size()),
+              working_time(solution->truck_working_time)
+        {
+            working_time.insert(working_time.end(), solution->drone_working_time.begin(), solution->drone_working_time.end());
+            _add_routes(solution->truck_routes, false);
+            _add_routes(solution->drone_routes, true);
+        }
+
+        /** @brief Service time of `customer` by the vehicle owning `route`. */
+        double service_time(const std::size_t &route, const std::size_t &customer) const
+        {
+            auto problem = Problem::get_instance();
+            return routes[route].drone ? problem->customers[customer].drone_service_time : problem->customers[customer].truck_service_time;
+        }
+
+        /** @brief Whether `customer` can be served by the vehicle owning `route`. */
+        bool allowed(const std::size_t &route, const std::size_t &customer) const
+        {
+            return !routes[route].drone || Problem::get_instance()->drone_serviceable[customer];
+        }
+
+        /**
+         * @brief Estimate the working time of the most loaded vehicle after a move.
+         *
+         * @param deltas Pairs of a route index and the estimated change in working time of its vehicle
+         */
+        double makespan(const std::vector<std::pair<std::size_t, double>> &deltas) const
+        {
+            std::vector<double> time(working_time);
+            for (auto &[route, delta] : deltas)
+            {
+                time[routes[route].global_vehicle] += delta;
+            }
+
+            return *std::max_element(time.begin(), time.end());
+        }
+
+        /**
+         * @brief Apply modifications of distinct routes to scratch routes, to be reverted with
+         * `ScratchRoutes::undo`.
+         *
+         * Modifications are sorted in decreasing order of route index, so that removing emptied routes does not
+         * shift the indices of routes yet to be modified.
+         */
+        void apply(std::vector<Modification> &modifications, ScratchRoutes &scratch) const
+        {
+            std::sort(
+                modifications.begin(), modifications.end(),
+                [](const Modification &first, const Modification &second)
+                {
+                    return first.first > second.first;
+                });
+
+            for (auto &[route, customers] : modifications)
+            {
+                const auto &ref = routes[route];
+                if (ref.drone)
+                {
+                    scratch.assign<DroneRoute>(ref.vehicle, ref.index, customers);
+                }
+                else
+                {
+                    scratch.assign<TruckRoute>(ref.vehicle, ref.index, customers);
+                }
+            }
+        }
+
+    private:
+        template <typename RT>
+        void _add_routes(const std::vector<std::vector<RT>> &vehicle_routes, const bool &drone)
+        {
+            auto problem = Problem::get_instance();
+            const double time_factor = drone ? problem->drone->cruise_time(1) : 1 / problem->truck->average_speed;
+
+            bool found_empty = false;
+            for (std::size_t vehicle = 0; vehicle < vehicle_routes.size(); vehicle++)
+            {
+                const std::size_t global_vehicle = drone ? problem->trucks_count + vehicle : vehicle;
+                for (std::size_t index = 0; index < vehicle_routes[vehicle].size(); index++)
+                {
+                    const auto &customers = vehicle_routes[vehicle][index].customers();
+                    for (std::size_t i = 1; i + 1 < customers.size(); i++)
+                    {
+                        route_of[customers[i]] = routes.size();
+                        position_of[customers[i]] = i;
+                    }
+
+                    routes.push_back({drone, vehicle, index, global_vehicle, time_factor, &customers, &vehicle_routes[vehicle][index].geometry(), false});
+                }
+
+                const bool empty = vehicle_routes[vehicle].empty();
+                routes.push_back({drone, vehicle, vehicle_routes[vehicle].size(), global_vehicle, time_factor, nullptr, nullptr, empty && found_empty});
+                found_empty = found_empty || empty;
+            }
+        }
+    };
+}
@@ -0,0 +1,354 @@
+#pragma once
+
+#include "abc.hpp"
+#include "batch.hpp"
+#include "scratch.hpp"
+
+namespace d2d
+{
+    /**
+     * @brief Exchange 2 customers of different routes, reinserting each one at its best position in the other
+     * route instead of in place (SWAP*).
+     *
+     * For each route pair, the 3 cheapest insertion positions of every customer into the other route are computed
+     * first. The best reinsertion of a swapped customer is then found in `O(1)`: it is either in place of the
+     * removed customer, or the cheapest of these positions not adjacent to it. Only route pairs whose polar
+     * sectors around the depot overlap, and which are near each other as per `RouteGeometry::near`, are
+     * considered.
+     */
+    template <typename ST>
+    class SwapStar : public Neighborhood<ST, true>
+    {
+    private:
+        /** @brief Key of scans for `_look` */
+        static constexpr std::size_t _inter_look = 0;
+
+        static constexpr std::size_t _none = std::numeric_limits<std::size_t>::max();
+
+        /** @brief Inserting a customer before `customers[position]` changes the traveling distance by `cost`. */
+        struct _Insertion
+        {
+            double cost;
+            std::size_t position;
+        };
+
+        /** @brief The 3 cheapest positions to insert `customer` into `customers`, in increasing order of cost. */
+        static std::array<_Insertion, 3> _best_insertions(const std::size_t &customer, const RouteCustomers &customers)
+        {
+            auto problem = Problem::get_instance();
+            const auto &distances = problem->distances;
+
+            std::array<_Insertion, 3> result;
+            result.fill({std::numeric_limits<double>::max(), _none});
+            for (std::size_t position = 1; position < customers.size(); position++)
+            {
+                const auto &prev = customers[position - 1], &next = customers[position];
+                double cost = distances[prev][customer] + distances[customer][next] - distances[prev][next];
+                if (cost < result[2].cost)
+                {
+                    result[2] = {cost, position};
+                    for (std::size_t k = 2; k > 0 && result[k].cost < result[k - 1].cost; k--)
+                    {
+                        std::swap(result[k], result[k - 1]);
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Replace `customers[position]` with `customer` at its best position.
+         *
+         * @param insertions The result of `_best_insertions` for `customer`
+         * @return The change in traveling distance, and the position before which `customer` is inserted once
+         * `customers[position]` is removed, or `position` itself to replace it in place
+         */
+        static std::pair<double, std::size_t> _reinsertion(
+            const RouteCustomers &customers,
+            const std::size_t &position,
+            const std::size_t &customer,
+            const std::array<_Insertion, 3> &insertions)
+        {
+            auto problem = Problem::get_instance();
+            const auto &distances = problem->distances;
+
+            const auto &prev = customers[position - 1], &removed = customers[position], &next = customers[position + 1];
+            const double removal = distances[prev][next] - distances[prev][removed] - distances[removed][next];
+
+            std::pair<double, std::size_t> result(removal - distances[prev][next] + distances[prev][customer] + distances[customer][next], position);
+            for (auto &insertion : insertions)
+            {
+                if (insertion.position == _none)
+                {
+                    break;
+                }
+
+                // Insertion positions adjacent to the removed customer are no longer valid
+                if (insertion.position != position && insertion.position != position + 1)
+                {
+                    if (removal + insertion.cost < result.first)
+                    {
+                        result = std::make_pair(removal + insertion.cost, insertion.position);
+                    }
+
+                    break;
+                }
+            }
+
+            return result;
+        }
+
+        template <typename _Alloc>
+        static void _replace(ScratchRoutes &scratch, const std::size_t &vehicle, const std::size_t &route, const std::vector<std::size_t, _Alloc> &customers)
+        {
+            auto problem = Problem::get_instance();
+            if (vehicle < problem->trucks_count)
+            {
+                scratch.replace<TruckRoute>(vehicle, route, customers);
+            }
+            else
+            {
+                scratch.replace<DroneRoute>(vehicle - problem->trucks_count, route, customers);
+            }
+        }
+
+        template <typename _AspirationCriteria>
+        void _inter_route_internal(
+            const std::shared_ptr<ST> solution,
+            const _AspirationCriteria &aspiration_criteria,
+            const std::shared_ptr<ParentInfo<ST>> parent,
+            std::shared_ptr<ST> &result,
+            std::vector<std::size_t> &tabu,
+            ScratchRoutes &scratch,
+            const std::size_t &vehicle_i,
+            const std::size_t &route_i,
+            const RouteCustomers &customers_i,
+            const std::size_t &vehicle_j,
+            const std::size_t &route_j,
+            const RouteCustomers &customers_j)
+        {
+            auto problem = Problem::get_instance();
+            auto &arena = utils::Arena::local();
+            utils::Arena::Scope batch_scope(arena);
+
+            const bool drone_i = vehicle_i >= problem->trucks_count, drone_j = vehicle_j >= problem->trucks_count;
+            const RoutePrefix prefix_i(customers_i, &arena), prefix_j(customers_j, &arena);
+            const auto size_i = customers_i.size(), size_j = customers_j.size();
+
+            std::pmr::vector<std::array<_Insertion, 3>> into_i(size_j, &arena), into_j(size_i, &arena);
+            for (std::size_t i = 1; i + 1 < size_i; i++)
+            {
+                into_j[i] = _best_insertions(customers_i[i], customers_j);
+            }
+            for (std::size_t j = 1; j + 1 < size_j; j++)
+            {
+                into_i[j] = _best_insertions(customers_j[j], customers_i);
+            }
+
+            /* For drone routes, the number of customers of the other route each customer cannot share a trip with */
+            const auto conflicts = [&problem, &arena](const RouteCustomers &customers, const RouteCustomers &others, const bool &drone)
+            {
+                std::pmr::vector<std::uint32_t> result(customers.size(), 0, &arena);
+                for (std::size_t k = 1; drone && k + 1 < customers.size(); k++)
+                {
+                    const auto &compatible = problem->drone_compatible[customers[k]];
+                    for (std::size_t other = 1; other + 1 < others.size(); other++)
+                    {
+                        result[k] += !compatible[others[other]];
+                    }
+                }
+
+                return result;
+            };
+            const auto conflicts_i = conflicts(customers_i, customers_j, drone_j), conflicts_j = conflicts(customers_j, customers_i, drone_i);
+
+            const auto service_time = [&problem](const bool &drone, const std::size_t &customer)
+            {
+                return drone ? problem->customers[customer].drone_service_time : problem->customers[customer].truck_service_time;
+            };
+
+            /* Bound every swap, keeping the positions where the swapped customers are reinserted */
+            MoveBatch<ST> batch(solution, vehicle_i, route_i, vehicle_j, route_j, &arena);
+            std::pmr::vector<std::uint32_t> at_i(&arena), at_j(&arena);
+            for (std::size_t i = 1; i + 1 < size_i; i++)
+            {
+                const auto &u = customers_i[i];
+                if (drone_j && !problem->drone_serviceable[u])
+                {
+                    continue;
+                }
+
+                for (std::size_t j = 1; j + 1 < size_j; j++)
+                {
+                    const auto &v = customers_j[j];
+                    if (drone_i && !problem->drone_serviceable[v])
+                    {
+                        continue;
+                    }
+
+                    // Each swapped customer must be compatible with the remaining customers of its new drone route
+                    const bool incompatible = !problem->drone_compatible[u][v];
+                    if ((drone_j && conflicts_i[i] > incompatible) || (drone_i && conflicts_j[j] > incompatible))
+                    {
+                        continue;
+                    }
+
+                    auto [delta_i, position_i] = _reinsertion(customers_i, i, v, into_i[j]);
+                    auto [delta_j, position_j] = _reinsertion(customers_j, j, u, into_j[i]);
+
+                    typename MoveBatch<ST>::Route new_i{
+                        prefix_i.distance[size_i - 1] + delta_i,
+                        prefix_i.service_time(drone_i)[size_i - 1] - service_time(drone_i, u) + service_time(drone_i, v),
+                        prefix_i.weight[size_i - 1] - problem->customers[u].demand + problem->customers[v].demand,
+                        size_i,
+                        std::min(i, position_i)};
+                    typename MoveBatch<ST>::Route new_j{
+                        prefix_j.distance[size_j - 1] + delta_j,
+                        prefix_j.service_time(drone_j)[size_j - 1] - service_time(drone_j, v) + service_time(drone_j, u),
+                        prefix_j.weight[size_j - 1] - problem->customers[v].demand + problem->customers[u].demand,
+                        size_j,
+                        std::min(j, position_j)};
+
+                    batch.push(i, j, new_i, new_j);
+                    at_i.push_back(position_i);
+                    at_j.push_back(position_j);
+                }
+            }
+
+            batch.evaluate();
+
+            /* Build the swaps that may be useful */
+            const auto reinserted = [&arena](const RouteCustomers &customers, const std::size_t &position, const std::size_t &customer, const std::size_t &at)
+            {
+                std::pmr::vector<std::size_t> route(customers.begin(), customers.end(), &arena);
+                if (at == position)
+                {
+                    route[position] = customer;
+                }
+                else
+                {
+                    route.erase(route.begin() + position);
+                    route.insert(route.begin() + (at > position ? at - 1 : at), customer);
+                }
+
+                return route;
+            };
+
+            for (std::size_t k = 0; k < batch.size(); k++)
+            {
+                if (!this->_promising(result, batch.bound(k)))
+                {
+                    continue;
+                }
+
+                const std::size_t i = batch.i[k], j = batch.j[k];
+                const auto &u = customers_i[i], &v = customers_j[j];
+
+                utils::Arena::Scope scope(arena);
+                _replace(scratch, vehicle_i, route_i, reinserted(customers_i, i, v, at_i[k]));
+                _replace(scratch, vehicle_j, route_j, reinserted(customers_j, j, u, at_j[k]));
+
+                auto new_solution = this->construct(parent, solution, scratch, result);
+                if (new_solution != nullptr &&
+                    solution->cost() != new_solution->cost() &&
+                    (aspiration_criteria(new_solution) || !this->is_tabu(u, v)) &&
+                    (result == nullptr || new_solution->cost() < result->cost()))
+                {
+                    result = new_solution;
+                    tabu = {u, v};
+                }
+
+                /* Restore */
+                scratch.undo();
+            }
+        }
+
+    public:
+        std::string label() const override
+        {
+            return "SWAP*";
+        }
+
+        template <typename _AspirationCriteria>
+        std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
+            const std::shared_ptr<ST> solution,
+            const _AspirationCriteria &aspiration_criteria)
+        {
+            return std::make_pair(nullptr, std::vector<std::size_t>());
+        }
+
+        template <typename _AspirationCriteria>
+        std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
+            const std::shared_ptr<ST> solution,
+            const _AspirationCriteria &aspiration_criteria)
+        {
+            auto problem = Problem::get_instance();
+            auto parent = this->parent_ptr(solution);
+            std::shared_ptr<ST> result;
+            std::vector<std::size_t> tabu;
+
+            /* Routes of each vehicle, trucks first */
+            const auto vehicles_count = problem->trucks_count + problem->drones_count;
+            std::vector<std::vector<const RouteCustomers *>> customers(vehicles_count);
+            std::vector<std::vector<const RouteGeometry *>> geometries(vehicles_count);
+            for (std::size_t vehicle = 0; vehicle < vehicles_count; vehicle++)
+            {
+                const auto add = [&customers, &geometries, &vehicle](const auto &routes)
+                {
+                    for (auto &route : routes)
+                    {
+                        customers[vehicle].push_back(&route.customers());
+                        geometries[vehicle].push_back(&route.geometry());
+                    }
+                };
+
+                if (vehicle < problem->trucks_count)
+                {
+                    add(solution->truck_routes[vehicle]);
+                }
+                else
+                {
+                    add(solution->drone_routes[vehicle - problem->trucks_count]);
+                }
+            }
+
+            ScratchRoutes scratch(solution);
+            for (std::size_t vehicle_i = 0; vehicle_i < vehicles_count; vehicle_i++)
+            {
+                for (std::size_t vehicle_j = vehicle_i; vehicle_j < vehicles_count; vehicle_j++)
+                {
+                    if (this->_no_route_pairs(solution, vehicle_i, vehicle_j) ||
+                        !this->_look(solution, result, _inter_look, vehicle_i, vehicle_j))
+                    {
+                        continue;
+                    }
+
+                    for (std::size_t route_i = 0; route_i < customers[vehicle_i].size(); route_i++)
+                    {
+                        for (std::size_t route_j = vehicle_i == vehicle_j ? route_i + 1 : 0; route_j < customers[vehicle_j].size(); route_j++)
+                        {
+                            const auto &geometry_i = *geometries[vehicle_i][route_i], &geometry_j = *geometries[vehicle_j][route_j];
+                            if (geometry_i.overlaps(geometry_j) && geometry_i.near(geometry_j))
+                            {
+                                _inter_route_internal(
+                                    solution,
+                                    aspiration_criteria,
+                                    parent,
+                                    result,
+                                    tabu,
+                                    scratch,
+                                    vehicle_i, route_i, *customers[vehicle_i][route_i],
+                                    vehicle_j, route_j, *customers[vehicle_j][route_j]);
+                            }
+                        }
+                    }
+
+                    this->_looked();
+                }
+            }
+
+            return std::make_pair(result, tabu);
+        }
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "abc.hpp"
+#include "batch.hpp"
+#include "scratch.hpp"
 
 namespace d2d
 {
@@ -8,24 +10,32 @@ namespace d2d
     class TwoOpt : public Neighborhood<ST, true>
     {
     private:
-        template <typename _RT, std::enable_if_t<is_route_v<_RT>, bool> = true>
+        /** @brief Keys of scans for `_look` */
+        static constexpr std::size_t _intra_look = 0, _inter_look = 1;
+
+        template <typename _RT, typename _AspirationCriteria, std::enable_if_t<is_route_v<_RT>, bool> = true>
         void _intra_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AspirationCriteria &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
-            std::vector<std::vector<TruckRoute>> &truck_routes,
-            std::vector<std::vector<DroneRoute>> &drone_routes)
+            ScratchRoutes &scratch)
         {
             auto problem = Problem::get_instance();
+            auto &arena = utils::Arena::local();
 
             auto vehicles_count = utils::ternary<std::is_same_v<_RT, TruckRoute>>(problem->trucks_count, problem->drones_count);
-            auto &vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(truck_routes, drone_routes);
             auto &original_vehicle_routes = utils::match_type<std::vector<std::vector<_RT>>>(solution->truck_routes, solution->drone_routes);
 
             for (std::size_t index = 0; index < vehicles_count; index++)
             {
+                const auto vehicle = utils::ternary<std::is_same_v<_RT, TruckRoute>>(index, problem->trucks_count + index);
+                if (!this->_look(solution, result, _intra_look, vehicle, vehicle))
+                {
+                    continue;
+                }
+
                 for (std::size_t route = 0; route < original_vehicle_routes[index].size(); route++)
                 {
                     const auto &customers = original_vehicle_routes[index][route].customers();
@@ -33,14 +43,21 @@ namespace d2d
                     {
                         for (std::size_t j = i + 1; j + 1 < customers.size(); j++)
                         {
+                            if (!this->_promising(result))
+                            {
+                                continue;
+                            }
+
                             /* Reverse segment [i, j] */
-                            std::vector<std::size_t> new_customers(customers);
+                            utils::Arena::Scope scope(arena);
+                            std::pmr::vector<std::size_t> new_customers(customers.begin(), customers.end(), &arena);
                             std::reverse(new_customers.begin() + i, new_customers.begin() + (j + 1));
 
-                            vehicle_routes[index][route] = _RT(new_customers);
+                            scratch.replace<_RT>(index, route, new_customers);
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
+                            auto new_solution = this->construct(parent, solution, scratch, result);
+                            if (new_solution != nullptr &&
+                                solution->cost() != new_solution->cost() &&
                                 (aspiration_criteria(new_solution) || !this->is_tabu(customers[i - 1], customers[j])) &&
                                 (result == nullptr || new_solution->cost() < result->cost()))
                             {
@@ -49,32 +66,86 @@ namespace d2d
                             }
 
                             /* Restore */
-                            vehicle_routes[index][route] = original_vehicle_routes[index][route];
+                            scratch.undo();
                         }
                     }
                 }
+
+                this->_looked();
             }
         }
 
+        /**
+         * @brief Bound all candidates swapping `[i + 1, end())` of `route_i` with `[j + 1, end())` of `route_j`, in
+         * the enumeration order of `_inter_route_internal`.
+         */
         template <typename _RT_I, typename _RT_J, std::enable_if_t<is_route_v<_RT_I, _RT_J>, bool> = true>
+        static MoveBatch<ST> _inter_route_batch(
+            const std::shared_ptr<ST> &solution,
+            const std::size_t &vehicle_i,
+            const std::size_t &route_i,
+            const std::size_t &vehicle_j,
+            const std::size_t &route_j,
+            const RoutePrefix &prefix_i,
+            const RoutePrefix &prefix_j,
+            utils::Arena &arena)
+        {
+            auto problem = Problem::get_instance();
+            const auto &distances = problem->distances;
+
+            const auto &customers_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes, solution->drone_routes)[utils::ternary<std::is_same_v<_RT_I, TruckRoute>>(vehicle_i, vehicle_i - problem->trucks_count)][route_i].customers();
+            const auto &customers_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes, solution->drone_routes)[utils::ternary<std::is_same_v<_RT_J, TruckRoute>>(vehicle_j, vehicle_j - problem->trucks_count)][route_j].customers();
+
+            const auto &service_i = prefix_i.service_time(std::is_same_v<_RT_I, DroneRoute>);
+            const auto &service_j = prefix_j.service_time(std::is_same_v<_RT_J, DroneRoute>);
+            const auto &moved_service_i = prefix_i.service_time(std::is_same_v<_RT_J, DroneRoute>);
+            const auto &moved_service_j = prefix_j.service_time(std::is_same_v<_RT_I, DroneRoute>);
+
+            const auto size_i = customers_i.size(), size_j = customers_j.size();
+
+            MoveBatch<ST> batch(solution, vehicle_i, route_i, vehicle_j, route_j, &arena);
+            for (std::size_t i = 0; i + 1 < size_i; i++)
+            {
+                for (std::size_t j = 0; j + 1 < size_j; j++)
+                {
+                    typename MoveBatch<ST>::Route new_i{
+                        prefix_i.distance[i] + distances[customers_i[i]][customers_j[j + 1]] + (prefix_j.distance[size_j - 1] - prefix_j.distance[j + 1]),
+                        service_i[i + 1] + (moved_service_j[size_j - 1] - moved_service_j[j + 1]),
+                        prefix_i.weight[i + 1] + (prefix_j.weight[size_j - 1] - prefix_j.weight[j + 1]),
+                        size_j + i - j,
+                        i + 1};
+                    typename MoveBatch<ST>::Route new_j{
+                        prefix_j.distance[j] + distances[customers_j[j]][customers_i[i + 1]] + (prefix_i.distance[size_i - 1] - prefix_i.distance[i + 1]),
+                        service_j[j + 1] + (moved_service_i[size_i - 1] - moved_service_i[i + 1]),
+                        prefix_j.weight[j + 1] + (prefix_i.weight[size_i - 1] - prefix_i.weight[i + 1]),
+                        size_i + j - i,
+                        j + 1};
+
+                    batch.push(i, j, new_i, new_j);
+                }
+            }
+
+            batch.evaluate();
+            return batch;
+        }
+
+        template <typename _RT_I, typename _RT_J, typename _AspirationCriteria, std::enable_if_t<is_route_v<_RT_I, _RT_J>, bool> = true>
         void _inter_route_internal(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria,
+            const _AspirationCriteria &aspiration_criteria,
             const std::shared_ptr<ParentInfo<ST>> parent,
             std::shared_ptr<ST> &result,
             std::vector<std::size_t> &tabu,
-            std::vector<std::vector<TruckRoute>> &truck_routes,
-            std::vector<std::vector<DroneRoute>> &drone_routes,
+            ScratchRoutes &scratch,
             const std::size_t &vehicle_i,
             const std::size_t &vehicle_j)
         {
             auto problem = Problem::get_instance();
+            auto &arena = utils::Arena::local();
 
             std::size_t _vehicle_i = utils::ternary<std::is_same_v<_RT_I, TruckRoute>>(vehicle_i, vehicle_i - problem->trucks_count);
             std::size_t _vehicle_j = utils::ternary<std::is_same_v<_RT_J, TruckRoute>>(vehicle_j, vehicle_j - problem->trucks_count);
 
-            auto &vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(truck_routes, drone_routes);
-            auto &vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(truck_routes, drone_routes);
             auto &original_vehicle_routes_i = utils::match_type<std::vector<std::vector<_RT_I>>>(solution->truck_routes, solution->drone_routes);
             auto &original_vehicle_routes_j = utils::match_type<std::vector<std::vector<_RT_J>>>(solution->truck_routes, solution->drone_routes);
 
@@ -90,18 +161,26 @@ namespace d2d
                         }
                     }
 
+                    if (!original_vehicle_routes_i[_vehicle_i][route_i].geometry().near(original_vehicle_routes_j[_vehicle_j][route_j].geometry()))
+                    {
+                        continue;
+                    }
+
                     const auto &customers_i = original_vehicle_routes_i[_vehicle_i][route_i].customers();
                     const auto &customers_j = original_vehicle_routes_j[_vehicle_j][route_j].customers();
 
+                    utils::Arena::Scope batch_scope(arena);
+                    const RoutePrefix prefix_i(customers_i, &arena), prefix_j(customers_j, &arena);
+                    const auto batch = _inter_route_batch<_RT_I, _RT_J>(solution, vehicle_i, route_i, vehicle_j, route_j, prefix_i, prefix_j, arena);
+
+                    std::size_t k = 0;
                     for (std::size_t i = 0; i + 1 < customers_i.size(); i++)
                     {
-                        for (std::size_t j = 0; j + 1 < customers_j.size(); j++)
+                        for (std::size_t j = 0; j + 1 < customers_j.size(); j++, k++)
                         {
                             if constexpr (std::is_same_v<_RT_I, DroneRoute> && std::is_same_v<_RT_J, TruckRoute>)
                             {
-                                if (std::any_of(
-                                        customers_j.begin() + (j + 1), customers_j.end(), [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
+                                if (!prefix_j.dronable(j + 1, customers_j.size()))
                                 {
                                     continue;
                                 }
@@ -109,41 +188,41 @@ namespace d2d
 
                             if constexpr (std::is_same_v<_RT_I, TruckRoute> && std::is_same_v<_RT_J, DroneRoute>)
                             {
-                                if (std::any_of(
-                                        customers_i.begin() + (i + 1), customers_i.end(), [&problem](const std::size_t &c)
-                                        { return !problem->customers[c].dronable; }))
+                                if (!prefix_i.dronable(i + 1, customers_i.size()))
                                 {
                                     continue;
                                 }
                             }
 
+                            if (!this->_promising(result, batch.bound(k)))
+                            {
+                                continue;
+                            }
+
                             /* Swap [i + 1, end()) of route_i and [j + 1, end()) of route_j */
-                            std::vector<std::size_t> ri(customers_i.begin(), customers_i.begin() + (i + 1));
-                            std::vector<std::size_t> rj(customers_j.begin(), customers_j.begin() + (j + 1));
+                            utils::Arena::Scope scope(arena);
+                            std::pmr::vector<std::size_t> ri(customers_i.begin(), customers_i.begin() + (i + 1), &arena);
+                            std::pmr::vector<std::size_t> rj(customers_j.begin(), customers_j.begin() + (j + 1), &arena);
 
                             ri.insert(ri.end(), customers_j.begin() + (j + 1), customers_j.end());
                             rj.insert(rj.end(), customers_i.begin() + (i + 1), customers_i.end());
 
                             /* Temporary modify */
-                            bool ri_empty = (ri.size() == 2), rj_empty = (rj.size() == 2); /* Note: At least 1 flag is false */
-                            if (ri_empty)
-                            {
-                                vehicle_routes_j[_vehicle_j][route_j] = _RT_J(rj);
-                                vehicle_routes_i[_vehicle_i].erase(vehicle_routes_i[_vehicle_i].begin() + route_i);
-                            }
-                            else if (rj_empty)
+                            /* Note: At least 1 route is not empty. Erasing an emptied route last keeps the other index valid */
+                            if (ri.size() == 2)
                             {
-                                vehicle_routes_i[_vehicle_i][route_i] = _RT_I(ri);
-                                vehicle_routes_j[_vehicle_j].erase(vehicle_routes_j[_vehicle_j].begin() + route_j);
+                                scratch.assign<_RT_J>(_vehicle_j, route_j, rj);
+                                scratch.assign<_RT_I>(_vehicle_i, route_i, ri);
                             }
                             else
                             {
-                                vehicle_routes_i[_vehicle_i][route_i] = _RT_I(ri);
-                                vehicle_routes_j[_vehicle_j][route_j] = _RT_J(rj);
+                                scratch.assign<_RT_I>(_vehicle_i, route_i, ri);
+                                scratch.assign<_RT_J>(_vehicle_j, route_j, rj);
                             }
 
-                            auto new_solution = this->construct(parent, truck_routes, drone_routes);
-                            if (solution->cost() != new_solution->cost() &&
+                            auto new_solution = this->construct(parent, solution, scratch, result);
+                            if (new_solution != nullptr &&
+                                solution->cost() != new_solution->cost() &&
                                 (aspiration_criteria(new_solution) || !this->is_tabu(customers_i[i], customers_j[j])) &&
                                 (result == nullptr || new_solution->cost() < result->cost()))
                             {
@@ -152,8 +231,7 @@ namespace d2d
                             }
 
                             /* Restore */
-                            vehicle_routes_i[_vehicle_i] = original_vehicle_routes_i[_vehicle_i];
-                            vehicle_routes_j[_vehicle_j] = original_vehicle_routes_j[_vehicle_j];
+                            scratch.undo();
                         }
                     }
                 }
@@ -166,40 +244,46 @@ namespace d2d
             return "2-opt";
         }
 
+        template <typename _AspirationCriteria>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> intra_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AspirationCriteria &aspiration_criteria)
         {
             auto parent = this->parent_ptr(solution);
 
             std::shared_ptr<ST> result;
             std::vector<std::size_t> tabu;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            ScratchRoutes scratch(solution);
 
-            _intra_route_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes);
-            _intra_route_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, truck_routes, drone_routes);
+            _intra_route_internal<TruckRoute>(solution, aspiration_criteria, parent, result, tabu, scratch);
+            _intra_route_internal<DroneRoute>(solution, aspiration_criteria, parent, result, tabu, scratch);
 
             return std::make_pair(result, tabu);
         }
 
+        template <typename _AspirationCriteria>
         std::pair<std::shared_ptr<ST>, std::vector<std::size_t>> inter_route(
             const std::shared_ptr<ST> solution,
-            const std::function<bool(const std::shared_ptr<ST>)> &aspiration_criteria) override
+            const _AspirationCriteria &aspiration_criteria)
         {
             auto problem = Problem::get_instance();
             auto parent = this->parent_ptr(solution);
             std::shared_ptr<ST> result;
             std::vector<std::size_t> tabu;
 
-            std::vector<std::vector<TruckRoute>> truck_routes(solution->truck_routes);
-            std::vector<std::vector<DroneRoute>> drone_routes(solution->drone_routes);
+            ScratchRoutes scratch(solution);
 
             for (std::size_t vehicle_i = 0; vehicle_i < problem->trucks_count + problem->drones_count; vehicle_i++)
             {
                 for (std::size_t vehicle_j = vehicle_i; vehicle_j < problem->trucks_count + problem->drones_count; vehicle_j++)
                 {
+                    if (this->_no_route_pairs(solution, vehicle_i, vehicle_j) ||
+                        !this->_look(solution, result, _inter_look, vehicle_i, vehicle_j))
+                    {
+                        continue;
+                    }
+
                     if (vehicle_i < problem->trucks_count)
                     {
                         if (vehicle_j < problem->trucks_count)
@@ -209,8 +293,7 @@ namespace d2d
                                 aspiration_criteria,
                                 parent, result,
                                 tabu,
-                                truck_routes,
-                                drone_routes,
+                                scratch,
                                 vehicle_i,
                                 vehicle_j);
                         }
@@ -221,8 +304,7 @@ namespace d2d
                                 aspiration_criteria,
                                 parent, result,
                                 tabu,
-                                truck_routes,
-                                drone_routes,
+                                scratch,
                                 vehicle_i,
                                 vehicle_j);
                         }
@@ -234,11 +316,12 @@ namespace d2d
                             aspiration_criteria,
                             parent, result,
                             tabu,
-                            truck_routes,
-                            drone_routes,
+                            scratch,
                             vehicle_i,
                             vehicle_j);
                     }
+
+                    this->_looked();
                 }
             }
 
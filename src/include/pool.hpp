@@ -0,0 +1,173 @@
+#pragma once
+
+#include "utils.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A per-thread stack of objects kept for reuse, so that containers can be recycled together with
+     * their allocated capacity.
+     */
+    template <typename T>
+    class RecyclingPool
+    {
+    private:
+        static constexpr std::size_t _capacity = 32;
+
+        std::vector<T> _free;
+        bool *const _destroyed;
+
+        explicit RecyclingPool(bool *destroyed) : _destroyed(destroyed) {}
+
+    public:
+        RecyclingPool(const RecyclingPool &) = delete;
+        RecyclingPool &operator=(const RecyclingPool &) = delete;
+
+        ~RecyclingPool()
+        {
+            *_destroyed = true;
+        }
+
+        /** @brief The pool of the calling thread, or `nullptr` if it was already destroyed at thread exit. */
+        static RecyclingPool *local()
+        {
+            thread_local bool destroyed = false;
+            thread_local RecyclingPool pool(&destroyed);
+            return destroyed ? nullptr : &pool;
+        }
+
+        /** @brief Take an object from the pool, or a default-constructed one if the pool is empty. */
+        T take()
+        {
+            if (_free.empty())
+            {
+                return T();
+            }
+
+            T result = std::move(_free.back());
+            _free.pop_back();
+            return result;
+        }
+
+        /** @brief Return an object to the pool. It is simply destroyed if the pool is full. */
+        void give(T &&value)
+        {
+            if (_free.size() < _capacity)
+            {
+                _free.push_back(std::move(value));
+            }
+        }
+    };
+
+    /**
+     * @brief An allocator recycling single-object allocations through a per-thread free list.
+     *
+     * Intended for `std::allocate_shared`, where the object and its control block share one allocation of a
+     * fixed size.
+     */
+    template <typename T>
+    class PoolAllocator
+    {
+    private:
+        class _FreeList
+        {
+        private:
+            static constexpr std::size_t _capacity = 256;
+
+            std::vector<T *> _blocks;
+            bool *const _destroyed;
+
+        public:
+            explicit _FreeList(bool *destroyed) : _destroyed(destroyed) {}
+
+            _FreeList(const _FreeList &) = delete;
+            _FreeList &operator=(const _FreeList &) = delete;
+
+            ~_FreeList()
+            {
+                for (auto &block : _blocks)
+                {
+                    std::allocator<T>().deallocate(block, 1);
+                }
+
+                *_destroyed = true;
+            }
+
+            T *pop()
+            {
+                if (_blocks.empty())
+                {
+                    return nullptr;
+                }
+
+                auto block = _blocks.back();
+                _blocks.pop_back();
+                return block;
+            }
+
+            bool push(T *block)
+            {
+                if (_blocks.size() < _capacity)
+                {
+                    _blocks.push_back(block);
+                    return true;
+                }
+
+                return false;
+            }
+        };
+
+        static _FreeList *_local()
+        {
+            thread_local bool destroyed = false;
+            thread_local _FreeList free_list(&destroyed);
+            return destroyed ? nullptr : &free_list;
+        }
+
+    public:
+        using value_type = T;
+
+        PoolAllocator() = default;
+
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U> &) {}
+
+        T *allocate(const std::size_t &n)
+        {
+            if (n == 1)
+            {
+                auto free_list = _local();
+                if (free_list != nullptr)
+                {
+                    auto block = free_list->pop();
+                    if (block != nullptr)
+                    {
+                        return block;
+                    }
+                }
+            }
+
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T *block, const std::size_t &n)
+        {
+            if (n == 1)
+            {
+                auto free_list = _local();
+                if (free_list != nullptr && free_list->push(block))
+                {
+                    return;
+                }
+            }
+
+            std::allocator<T>().deallocate(block, n);
+        }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U> &) const
+        {
+            return true;
+        }
+    };
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "bitvector.hpp"
 #include "config.hpp"
 #include "format.hpp"
 
@@ -14,19 +15,24 @@ namespace d2d
         const double truck_service_time;
         const double drone_service_time;
 
+        /** @brief Polar angle around the depot, in range [0, 2 * M_PI) */
+        const double angle;
+
         Customer(
             const double x,
             const double y,
             const double demand,
             const bool dronable,
             const double truck_service_time,
-            const double drone_service_time)
+            const double drone_service_time,
+            const double angle)
             : x(x),
               y(y),
               demand(demand),
               dronable(dronable),
               truck_service_time(truck_service_time),
-              drone_service_time(drone_service_time) {}
+              drone_service_time(drone_service_time),
+              angle(angle) {}
     };
 
     class Problem
@@ -51,7 +57,10 @@ namespace d2d
 
             const std::size_t &reset_after_factor,
             const double &diversification_factor,
-            const std::size_t &max_elite_size)
+            const std::size_t &max_elite_size,
+            const std::size_t &extra_initial,
+            const std::size_t &cross_exchange_length,
+            const double &proximity_factor)
             : tabu_size_factor(tabu_size_factor),
               verbose(verbose),
               trucks_count(trucks_count),
@@ -67,8 +76,102 @@ namespace d2d
               endurance(endurance),
               reset_after_factor(reset_after_factor),
               diversification_factor(diversification_factor),
-              max_elite_size(max_elite_size)
+              max_elite_size(max_elite_size),
+              extra_initial(extra_initial),
+              cross_exchange_length(cross_exchange_length),
+              proximity_factor(proximity_factor),
+              drone_serviceable(_drone_serviceable()),
+              drone_compatible(_drone_compatible())
+        {
+        }
+
+        /**
+         * @brief Whether a drone can serve `trip` (customers in visiting order, excluding the depot) on a route of
+         * its own without violating capacity, energy, fixed time or waiting time constraints.
+         *
+         * Adding customers to a drone route never decreases any of these quantities, so a trip violating them
+         * stays infeasible in any route containing it.
+         */
+        bool _drone_trip_feasible(const std::vector<std::size_t> &trip) const
         {
+            std::vector<std::size_t> route = {0};
+            route.insert(route.end(), trip.begin(), trip.end());
+            route.push_back(0);
+
+            double weight = 0, energy = 0, working_time = 0;
+            std::vector<double> time_segments;
+            for (std::size_t i = 0; i + 1 < route.size(); i++)
+            {
+                weight += customers[route[i]].demand;
+
+                const double cruise_time = drone->cruise_time(distances[route[i]][route[i + 1]]);
+                time_segments.push_back(customers[route[i]].drone_service_time + drone->takeoff_time() + cruise_time + drone->landing_time());
+                working_time += time_segments.back();
+                energy += drone->takeoff_time() * drone->takeoff_power(weight) +
+                          cruise_time * drone->cruise_power(weight) +
+                          drone->landing_time() * drone->landing_power(weight);
+            }
+
+            if (weight - drone->capacity >= TOLERANCE)
+            {
+                return false;
+            }
+
+            const double battery = linear != nullptr ? linear->battery : (nonlinear != nullptr ? nonlinear->battery : std::numeric_limits<double>::max());
+            if (energy - battery >= TOLERANCE)
+            {
+                return false;
+            }
+
+            if (endurance != nullptr && working_time - endurance->fixed_time >= TOLERANCE)
+            {
+                return false;
+            }
+
+            double time = 0;
+            for (std::size_t i = route.size() - 2; i > 0; i--)
+            {
+                time += time_segments[i];
+                if (time - customers[route[i]].drone_service_time - maximum_waiting_time >= TOLERANCE)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        utils::BitVector _drone_serviceable() const
+        {
+            utils::BitVector result(customers.size());
+            result.set(0);
+            for (std::size_t customer = 1; customer < customers.size(); customer++)
+            {
+                if (customers[customer].dronable && _drone_trip_feasible({customer}))
+                {
+                    result.set(customer);
+                }
+            }
+
+            return result;
+        }
+
+        std::vector<utils::BitVector> _drone_compatible() const
+        {
+            std::vector<utils::BitVector> result(customers.size(), utils::BitVector(customers.size()));
+            for (std::size_t i = 1; i < customers.size(); i++)
+            {
+                for (std::size_t j = i + 1; j < customers.size(); j++)
+                {
+                    if (drone_serviceable[i] && drone_serviceable[j] && (_drone_trip_feasible({i, j}) || _drone_trip_feasible({j, i})))
+                    {
+                        result[i].set(j);
+                        result[j].set(i);
+                    }
+                }
+            }
+
+            return result;
         }
 
         ~Problem()
@@ -96,6 +199,30 @@ namespace d2d
         const double diversification_factor;
         const std::size_t max_elite_size;
 
+        /** @brief The number of additional randomized initial solutions to construct */
+        const std::size_t extra_initial;
+
+        /** @brief The maximum length of exchanged segments in CROSS-exchange, or 0 for no limit */
+        const std::size_t cross_exchange_length;
+
+        /**
+         * @brief Inter-route neighborhoods skip pairs of routes farther apart than this factor times
+         * `average_distance`, or 0 to consider all pairs
+         */
+        const double proximity_factor;
+
+        /**
+         * @brief Whether a drone can serve each customer on a round trip of its own without violating any
+         * constraint, which holds for the depot. Drone routes containing other customers are infeasible.
+         */
+        const utils::BitVector drone_serviceable;
+
+        /**
+         * @brief Whether a drone can serve each pair of customers (excluding the depot), in some order, on a trip of
+         * their own without violating any constraint. Drone routes containing an incompatible pair are infeasible.
+         */
+        const std::vector<utils::BitVector> drone_compatible;
+
         // These will be calculated later
         std::size_t tabu_size;
         std::size_t reset_after;
@@ -153,7 +280,13 @@ namespace d2d
             std::vector<Customer> customers;
             for (std::size_t i = 0; i < customers_count + 1; i++)
             {
-                customers.emplace_back(x[i], y[i], demands[i], dronable[i], truck_service_time[i], drone_service_time[i]);
+                double angle = std::atan2(y[i] - y[0], x[i] - x[0]);
+                if (angle < 0)
+                {
+                    angle += 2 * M_PI;
+                }
+
+                customers.emplace_back(x[i], y[i], demands[i], dronable[i], truck_service_time[i], drone_service_time[i], angle);
             }
 
             std::vector<std::vector<double>> distances(customers.size(), std::vector<double>(customers.size()));
@@ -263,9 +396,9 @@ namespace d2d
                 throw std::runtime_error(utils::format("Unknown drone energy model \"%s\"", drone_class.c_str()));
             }
 
-            std::size_t max_elite_size, reset_after_factor;
-            double diversification_factor;
-            std::cin >> max_elite_size >> reset_after_factor >> diversification_factor;
+            std::size_t max_elite_size, reset_after_factor, extra_initial, cross_exchange_length;
+            double diversification_factor, proximity_factor;
+            std::cin >> max_elite_size >> reset_after_factor >> diversification_factor >> extra_initial >> cross_exchange_length >> proximity_factor;
 
             _instance = new Problem(
                 tabu_size_factor,
@@ -286,7 +419,10 @@ namespace d2d
                 dynamic_cast<DroneEnduranceConfig *>(drone),
                 reset_after_factor,
                 diversification_factor,
-                max_elite_size);
+                max_elite_size,
+                extra_initial,
+                cross_exchange_length,
+                proximity_factor);
         }
 
         return _instance;
@@ -4,8 +4,9 @@
 
 namespace utils
 {
-    /** @brief A random number generator */
-    std::mt19937 rng(std::chrono::steady_clock::now().time_since_epoch().count());
+    /** @brief A random number generator, each thread owns a separately seeded instance */
+    thread_local std::mt19937 rng(
+        std::chrono::steady_clock::now().time_since_epoch().count() ^ std::hash<std::thread::id>()(std::this_thread::get_id()));
 
     /**
      * @brief Generate a random number in the range `[l, r]`
@@ -2,26 +2,253 @@
 
 #include "errors.hpp"
 #include "problem.hpp"
+#include "small_array.hpp"
 
 namespace d2d
 {
+    /**
+     * @brief Storage of the customers of a route. Typical drone routes fit in the inline buffer, hence copying them
+     * does not allocate.
+     */
+    using RouteCustomers = utils::SmallArray<std::uint32_t, 8>;
+
+    /** @brief The spatial extent of the customers of a route, excluding the depot. */
+    struct RouteGeometry
+    {
+        /** @brief The bounding box of the customers */
+        double min_x, min_y, max_x, max_y;
+
+        double centroid_x, centroid_y;
+
+        /** @brief An arc of polar angles around the depot covering all customers, from `start` to `start + extent` */
+        double sector_start, sector_extent;
+
+        template <typename _Container>
+        explicit RouteGeometry(const _Container &customers)
+            : min_x(std::numeric_limits<double>::max()),
+              min_y(std::numeric_limits<double>::max()),
+              max_x(std::numeric_limits<double>::lowest()),
+              max_y(std::numeric_limits<double>::lowest()),
+              centroid_x(0),
+              centroid_y(0)
+        {
+            auto problem = Problem::get_instance();
+            const auto &depot = problem->customers[0];
+
+            const std::size_t count = customers.size() - 2;
+            for (std::size_t i = 1; i + 1 < customers.size(); i++)
+            {
+                const auto &customer = problem->customers[customers[i]];
+                min_x = std::min(min_x, customer.x);
+                min_y = std::min(min_y, customer.y);
+                max_x = std::max(max_x, customer.x);
+                max_y = std::max(max_y, customer.y);
+                centroid_x += customer.x / count;
+                centroid_y += customer.y / count;
+            }
+
+            // The sector spans the angles of all customers on both sides of the angle of the centroid
+            const double center = std::atan2(centroid_y - depot.y, centroid_x - depot.x);
+            double low = 0, high = 0;
+            for (std::size_t i = 1; i + 1 < customers.size(); i++)
+            {
+                double diff = std::remainder(problem->customers[customers[i]].angle - center, 2 * M_PI);
+                low = std::min(low, diff);
+                high = std::max(high, diff);
+            }
+
+            sector_start = std::fmod(center + low + 4 * M_PI, 2 * M_PI);
+            sector_extent = high - low;
+        }
+
+        /** @brief A lower bound of the distance between a customer of this route and a customer of `other`. */
+        double separation(const RouteGeometry &other) const
+        {
+            return utils::distance(
+                std::max({0.0, other.min_x - max_x, min_x - other.max_x}),
+                std::max({0.0, other.min_y - max_y, min_y - other.max_y}));
+        }
+
+        /** @brief Whether the polar sectors of this route and `other` intersect. */
+        bool overlaps(const RouteGeometry &other) const
+        {
+            const auto within = [](const RouteGeometry &geometry, const double &angle)
+            {
+                double diff = angle - geometry.sector_start;
+                return (diff < 0 ? diff + 2 * M_PI : diff) <= geometry.sector_extent;
+            };
+
+            return within(*this, other.sector_start) || within(other, sector_start);
+        }
+
+        /**
+         * @brief Whether inter-route neighborhoods should consider moves between this route and `other`, according
+         * to `Problem::proximity_factor`.
+         */
+        bool near(const RouteGeometry &other) const
+        {
+            auto problem = Problem::get_instance();
+            return problem->proximity_factor == 0 || separation(other) <= problem->proximity_factor * problem->average_distance;
+        }
+    };
+
+    /**
+     * @brief Forward minimum slack of waiting times along a route, evaluated at a fixed departure time.
+     *
+     * Modifying a route from position `p` onwards delays the return to the depot, hence the waiting time of every
+     * customer before `p`, by the same amount. Keeping per-prefix aggregates of waiting times answers whether such
+     * a delay introduces a waiting time violation, and bounds the resulting violation, in O(1).
+     */
+    class WaitingTimeSlack
+    {
+    private:
+        /** @brief Aggregates over the customers before a position, excluding the depot. */
+        struct _Entry
+        {
+            /** @brief The time from serving the customer at this position until returning to the depot */
+            double return_time;
+
+            /** @brief The least amount by which the waiting time of a non-violating customer may grow */
+            double slack;
+
+            /** @brief The total waiting time violation */
+            double violation;
+
+            /** @brief The number of customers whose waiting time is already violated */
+            std::uint32_t violating;
+        };
+
+        utils::SmallArray<_Entry, 8> _entries;
+        double _violation = 0;
+
+    public:
+        WaitingTimeSlack() = default;
+
+        /**
+         * @param time_segment Returns the time segment starting at the customer of the given position
+         * @param service_time Returns the service time of the given customer
+         */
+        template <typename _Container, typename _TimeSegment, typename _ServiceTime>
+        WaitingTimeSlack(const _Container &customers, const _TimeSegment &time_segment, const _ServiceTime &service_time)
+        {
+            auto problem = Problem::get_instance();
+
+            thread_local std::vector<_Entry> entries;
+            entries.assign(customers.size(), _Entry{0, std::numeric_limits<double>::max(), 0, 0});
+
+            // A customer waits from the moment it is served until the vehicle returns to the depot
+            for (std::size_t i = customers.size() - 2; i > 0; i--)
+            {
+                entries[i].return_time = entries[i + 1].return_time + time_segment(i);
+                _violation += std::max(0.0, entries[i].return_time - service_time(customers[i]) - problem->maximum_waiting_time);
+            }
+
+            entries[0].return_time = entries[1].return_time + time_segment(0);
+            for (std::size_t p = 2; p < customers.size(); p++)
+            {
+                const double return_time = entries[p].return_time;
+                auto &entry = entries[p];
+                entry = entries[p - 1];
+                entry.return_time = return_time;
+
+                const double slack = problem->maximum_waiting_time - (entries[p - 1].return_time - service_time(customers[p - 1]));
+                if (slack < 0)
+                {
+                    entry.violation += -slack;
+                    entry.violating++;
+                }
+                else
+                {
+                    entry.slack = std::min(entry.slack, slack);
+                }
+            }
+
+            _entries = utils::SmallArray<_Entry, 8>(entries);
+        }
+
+        /** @brief The total waiting time violation of the route. */
+        double violation() const
+        {
+            return _violation;
+        }
+
+        /** @brief The time from serving the customer at `position` until returning to the depot. */
+        double return_time(const std::size_t &position) const
+        {
+            return _entries[position].return_time;
+        }
+
+        /**
+         * @brief Whether customers before `position` keep their waiting times within the limit when delayed by
+         * `delay`, and no customer from `position` onwards waits longer than `waiting_time`.
+         *
+         * @param delay The increase (or a lower bound of it) of the time to return to the depot
+         * @param waiting_time The largest waiting time (or a lower bound of it) among the customers from `position`
+         */
+        bool insertion_feasible(const std::size_t &position, const double &delay, const double &waiting_time) const
+        {
+            auto problem = Problem::get_instance();
+            const auto &entry = _entries[position];
+            return entry.violating == 0 && delay <= entry.slack + TOLERANCE && waiting_time <= problem->maximum_waiting_time + TOLERANCE;
+        }
+
+        /**
+         * @brief A lower bound of the total waiting time violation of customers before `position` once delayed by
+         * `delay`, which may be negative.
+         *
+         * The bound is exact unless the delay exceeds the slack of 2 or more non-violating customers, or a negative
+         * delay brings a violating customer back within the limit.
+         */
+        double delayed_violation(const std::size_t &position, const double &delay) const
+        {
+            const auto &entry = _entries[position];
+            return std::max(0.0, entry.violation + entry.violating * delay) + std::max(0.0, delay - entry.slack);
+        }
+
+        /**
+         * @brief A lower bound of the change in waiting time violation of customers before `position` when delayed by
+         * `delay`, see `delayed_violation`.
+         */
+        double violation_delta(const std::size_t &position, const double &delay) const
+        {
+            return delayed_violation(position, delay) - _entries[position].violation;
+        }
+    };
+
     class _BaseRoute
     {
     protected:
-        static double _calculate_distance(const std::vector<std::size_t> &customers);
-        static double _calculate_weight(const std::vector<std::size_t> &customers);
+        template <typename _Container>
+        static double _calculate_distance(const _Container &customers);
+        template <typename _Container>
+        static double _calculate_weight(const _Container &customers);
 
-        std::vector<std::size_t> _customers;
+        /**
+         * @brief Sum of waiting time violations of all customers of a route.
+         *
+         * @param time_segment Returns the time segment starting at the customer of the given position
+         * @param service_time Returns the service time of the given customer
+         */
+        template <typename _Container, typename _TimeSegment, typename _ServiceTime>
+        static double _calculate_waiting_time_violation(
+            const _Container &customers,
+            const _TimeSegment &time_segment,
+            const _ServiceTime &service_time);
+
+        RouteCustomers _customers;
         double _distance;
         double _weight;
+        RouteGeometry _geometry;
 
+        template <typename _Alloc>
         _BaseRoute(
-            const std::vector<std::size_t> &customers,
+            const std::vector<std::size_t, _Alloc> &customers,
             const double &distance,
             const double &weight)
             : _customers(customers),
               _distance(distance),
-              _weight(weight)
+              _weight(weight),
+              _geometry(customers)
         {
 #ifdef DEBUG
             if (customers.size() < 3)
@@ -37,18 +264,13 @@ namespace d2d
         }
 
     public:
-        static std::vector<double> calculate_waiting_time_violations(
-            const std::vector<std::size_t> &customers,
-            const std::vector<double> &time_segments,
-            const std::function<double(const std::size_t &)> service_time);
-
         /** @brief The amount of weight exceeding vehicle capacity. */
         virtual double capacity_violation() const = 0;
 
         /**
          * @brief The order of customers in this route, starting and ending at the depot `0`.
          */
-        const std::vector<std::size_t> &customers() const
+        const RouteCustomers &customers() const
         {
             return _customers;
         }
@@ -68,9 +290,18 @@ namespace d2d
         {
             return _weight;
         }
+
+        /**
+         * @brief The spatial extent of the customers of this route.
+         */
+        const RouteGeometry &geometry() const
+        {
+            return _geometry;
+        }
     };
 
-    double _BaseRoute::_calculate_distance(const std::vector<std::size_t> &customers)
+    template <typename _Container>
+    double _BaseRoute::_calculate_distance(const _Container &customers)
     {
         auto problem = Problem::get_instance();
         double distance = 0;
@@ -82,7 +313,8 @@ namespace d2d
         return distance;
     }
 
-    double _BaseRoute::_calculate_weight(const std::vector<std::size_t> &customers)
+    template <typename _Container>
+    double _BaseRoute::_calculate_weight(const _Container &customers)
     {
         auto problem = Problem::get_instance();
         double weight = 0;
@@ -94,47 +326,71 @@ namespace d2d
         return weight;
     }
 
-    std::vector<double> _BaseRoute::calculate_waiting_time_violations(
-        const std::vector<std::size_t> &customers,
-        const std::vector<double> &time_segments,
-        const std::function<double(const std::size_t &)> service_time)
+    template <typename _Container, typename _TimeSegment, typename _ServiceTime>
+    double _BaseRoute::_calculate_waiting_time_violation(
+        const _Container &customers,
+        const _TimeSegment &time_segment,
+        const _ServiceTime &service_time)
     {
         auto problem = Problem::get_instance();
-        std::vector<double> violations(customers.size());
+        double violation = 0, time = 0;
 
-        double time = std::accumulate(time_segments.begin(), time_segments.end(), 0.0);
-        for (std::size_t i = 0; i < customers.size(); i++)
+        // A customer waits from the moment it is served until the vehicle returns to the depot
+        for (std::size_t i = customers.size() - 2; i > 0; i--)
         {
-            violations[i] = std::max(0.0, time - service_time(customers[i]) - problem->maximum_waiting_time);
-            time -= time_segments[i];
+            time += time_segment(i);
+            violation += std::max(0.0, time - service_time(customers[i]) - problem->maximum_waiting_time);
         }
 
-        violations.front() = violations.back() = 0;
-
-        return violations;
+        return violation;
     }
 
     /** @brief Represents a truck route. */
     class TruckRoute : public _BaseRoute
     {
+    private:
+        template <typename _Container>
+        static void _calculate_time_segments(
+            const _Container &customers,
+            std::size_t &coefficients_index,
+            double &current_within_timespan,
+            std::vector<double> &time_segments);
+
     public:
-        static std::vector<double> calculate_time_segments(
-            const std::vector<std::size_t> &customers,
+        /**
+         * @brief Calculate the working time of a truck route departing at the time described by `coefficients_index`
+         * and `current_within_timespan`, which are then advanced to the time the truck returns to the depot.
+         *
+         * @param waiting_time_violation Increased by the total waiting time violation of the route
+         */
+        template <typename _Container>
+        static double calculate_working_time(
+            const _Container &customers,
+            std::size_t &coefficients_index,
+            double &current_within_timespan,
+            double &waiting_time_violation);
+
+        /**
+         * @brief The waiting time slack of a truck route departing at the time described by `coefficients_index`
+         * and `current_within_timespan`, which are then advanced to the time the truck returns to the depot.
+         */
+        template <typename _Container>
+        static WaitingTimeSlack waiting_time_slack(
+            const _Container &customers,
             std::size_t &coefficients_index,
             double &current_within_timespan);
-        static std::vector<double> calculate_waiting_time_violations(
-            const std::vector<std::size_t> &customers,
-            const std::vector<double> &time_segments);
 
         /** @brief Construct a `TruckRoute` with pre-calculated attributes */
+        template <typename _Alloc = std::allocator<std::size_t>>
         TruckRoute(
-            const std::vector<std::size_t> &customers,
+            const std::vector<std::size_t, _Alloc> &customers,
             const double &distance,
             const double &weight)
             : _BaseRoute(customers, distance, weight) {}
 
         /** @brief Construct a `TruckRoute` from a list of customers in order. */
-        TruckRoute(const std::vector<std::size_t> &customers)
+        template <typename _Alloc = std::allocator<std::size_t>>
+        TruckRoute(const std::vector<std::size_t, _Alloc> &customers)
             : TruckRoute(customers, _calculate_distance(customers), _calculate_weight(customers)) {}
 
         double capacity_violation() const override
@@ -150,19 +406,20 @@ namespace d2d
          */
         void push_back(const std::size_t &customer)
         {
-            std::vector<std::size_t> new_customers(_customers);
+            std::vector<std::size_t> new_customers(_customers.begin(), _customers.end());
             new_customers.insert(new_customers.end() - 1, customer);
             *this = TruckRoute(new_customers);
         }
     };
 
-    std::vector<double> TruckRoute::calculate_time_segments(
-        const std::vector<std::size_t> &customers,
+    template <typename _Container>
+    void TruckRoute::_calculate_time_segments(
+        const _Container &customers,
         std::size_t &coefficients_index,
-        double &current_within_timespan)
+        double &current_within_timespan,
+        std::vector<double> &time_segments)
     {
         auto problem = Problem::get_instance();
-        std::vector<double> time_segments;
 
         const auto shift = [&coefficients_index, &current_within_timespan](double *time_segment_ptr, double dt)
         {
@@ -175,7 +432,7 @@ namespace d2d
             }
         };
 
-        time_segments.reserve(customers.size() - 1);
+        time_segments.clear();
         for (std::size_t i = 0; i + 1 < customers.size(); i++)
         {
             double time_segment = 0, distance = problem->distances[customers[i]][customers[i + 1]];
@@ -192,18 +449,50 @@ namespace d2d
 
             time_segments.push_back(time_segment);
         }
+    }
+
+    template <typename _Container>
+    double TruckRoute::calculate_working_time(
+        const _Container &customers,
+        std::size_t &coefficients_index,
+        double &current_within_timespan,
+        double &waiting_time_violation)
+    {
+        // Reused across calls so that evaluating a route does not allocate
+        thread_local std::vector<double> time_segments;
+        _calculate_time_segments(customers, coefficients_index, current_within_timespan, time_segments);
+
+        auto problem = Problem::get_instance();
+        waiting_time_violation += _calculate_waiting_time_violation(
+            customers,
+            [](const std::size_t &i)
+            {
+                return time_segments[i];
+            },
+            [&problem](const std::size_t &customer)
+            {
+                return problem->customers[customer].truck_service_time;
+            });
 
-        return time_segments;
+        return std::accumulate(time_segments.begin(), time_segments.end(), 0.0);
     }
 
-    std::vector<double> TruckRoute::calculate_waiting_time_violations(
-        const std::vector<std::size_t> &customers,
-        const std::vector<double> &time_segments)
+    template <typename _Container>
+    WaitingTimeSlack TruckRoute::waiting_time_slack(
+        const _Container &customers,
+        std::size_t &coefficients_index,
+        double &current_within_timespan)
     {
+        thread_local std::vector<double> time_segments;
+        _calculate_time_segments(customers, coefficients_index, current_within_timespan, time_segments);
+
         auto problem = Problem::get_instance();
-        return _BaseRoute::calculate_waiting_time_violations(
+        return WaitingTimeSlack(
             customers,
-            time_segments,
+            [](const std::size_t &i)
+            {
+                return time_segments[i];
+            },
             [&problem](const std::size_t &customer)
             {
                 return problem->customers[customer].truck_service_time;
@@ -214,33 +503,35 @@ namespace d2d
     class DroneRoute : public _BaseRoute
     {
     private:
-        static std::vector<double> _calculate_time_segments(const std::vector<std::size_t> &customers);
-        static std::vector<double> _calculate_waiting_time_violations(
-            const std::vector<std::size_t> &customers,
-            const std::vector<double> &time_segments);
-        static double _calculate_energy_consumption(const std::vector<std::size_t> &customers);
-        static double _calculate_fixed_time_violation(const std::vector<double> &time_segments);
-
-        std::vector<double> _time_segments;
-        std::vector<double> _waiting_time_violations;
+        template <typename _Container>
+        static double _calculate_time_segment(const _Container &customers, const std::size_t &i);
+        template <typename _Container>
+        static double _calculate_working_time(const _Container &customers);
+        template <typename _Container>
+        static WaitingTimeSlack _calculate_waiting_time_slack(const _Container &customers);
+        template <typename _Container>
+        static double _calculate_energy_consumption(const _Container &customers);
+        static double _calculate_fixed_time_violation(const double &working_time);
+
         double _working_time;
+        WaitingTimeSlack _waiting_time_slack;
         double _energy_consumption;
         double _fixed_time_violation;
 
     public:
         /** @brief Construct a `DroneRoute` with pre-calculated attributes. */
+        template <typename _Alloc = std::allocator<std::size_t>>
         DroneRoute(
-            const std::vector<std::size_t> &customers,
-            const std::vector<double> &time_segments,
-            const std::vector<double> &waiting_time_violations,
+            const std::vector<std::size_t, _Alloc> &customers,
+            const double &working_time,
+            const WaitingTimeSlack &waiting_time_slack,
             const double &distance,
             const double &weight,
             const double &energy_consumption,
             const double &fixed_time_violation)
             : _BaseRoute(customers, distance, weight),
-              _time_segments(time_segments),
-              _waiting_time_violations(waiting_time_violations),
-              _working_time(std::accumulate(time_segments.begin(), time_segments.end(), 0.0)),
+              _working_time(working_time),
+              _waiting_time_slack(waiting_time_slack),
               _energy_consumption(energy_consumption),
               _fixed_time_violation(fixed_time_violation)
         {
@@ -256,71 +547,62 @@ namespace d2d
 #endif
         }
 
-        /**
-         * @brief Construct a `DroneRoute` with pre-calculated `time_segments`, `distance`, `weight`
-         * and `energy_consumption`.
-         */
+        /** @brief Construct a `DroneRoute` with pre-calculated `working_time`. */
+        template <typename _Alloc = std::allocator<std::size_t>>
         DroneRoute(
-            const std::vector<std::size_t> &customers,
-            const std::vector<double> &time_segments,
-            const double &distance,
-            const double &weight,
-            const double &energy_consumption)
+            const std::vector<std::size_t, _Alloc> &customers,
+            const double &working_time)
             : DroneRoute(
                   customers,
-                  time_segments,
-                  _calculate_waiting_time_violations(customers, time_segments),
-                  distance,
-                  weight,
-                  energy_consumption,
-                  _calculate_fixed_time_violation(time_segments)) {}
-
-        /** @brief Construct a `DroneRoute` with pre-calculated `time_segments`. */
-        DroneRoute(
-            const std::vector<std::size_t> &customers,
-            const std::vector<double> &time_segments)
-            : DroneRoute(
-                  customers,
-                  time_segments,
+                  working_time,
+                  _calculate_waiting_time_slack(customers),
                   _calculate_distance(customers),
                   _calculate_weight(customers),
-                  _calculate_energy_consumption(customers)) {}
-
-        /** @brief Construct a `DroneRoute` with pre-calculated `distance`, `weight` and `energy_consumption`. */
-        DroneRoute(
-            const std::vector<std::size_t> &customers,
-            const double &distance,
-            const double &weight,
-            const double &energy_consumption)
-            : DroneRoute(
-                  customers,
-                  _calculate_time_segments(customers),
-                  distance,
-                  weight,
-                  energy_consumption) {}
+                  _calculate_energy_consumption(customers),
+                  _calculate_fixed_time_violation(working_time)) {}
 
         /** @brief Construct a `DroneRoute` from a list of customers in order. */
-        DroneRoute(const std::vector<std::size_t> &customers)
-            : DroneRoute(customers, _calculate_time_segments(customers)) {}
+        template <typename _Alloc = std::allocator<std::size_t>>
+        DroneRoute(const std::vector<std::size_t, _Alloc> &customers)
+            : DroneRoute(customers, _calculate_working_time(customers)) {}
 
         /**
-         * @brief The time segments between each pair of adjacent customers.
+         * @brief The time segment between the customers at positions `i` and `i + 1` of this route.
          *
-         * Given a pair of adjacent customers `(x, y)` in this route, a time segment is the time
-         * from the moment the vehicle starts serving customer `x` to the moment it starts serving
-         * customer `y` (including service time of `x` but not `y`).
+         * A time segment is the time from the moment the vehicle starts serving the first customer to the moment
+         * it starts serving the second one (including service time of the first customer but not the second).
+         */
+        double time_segment(const std::size_t &i) const
+        {
+            return _calculate_time_segment(_customers, i);
+        }
+
+        /** @brief The time segment between customers `from` and `to` visited consecutively by a drone. */
+        static double time_segment_between(const std::size_t &from, const std::size_t &to)
+        {
+            auto problem = Problem::get_instance();
+            auto drone = problem->drone;
+            return problem->customers[from].drone_service_time +
+                   drone->takeoff_time() +
+                   drone->cruise_time(problem->distances[from][to]) +
+                   drone->landing_time();
+        }
+
+        /**
+         * @brief The total waiting time violation of customers in this route.
          */
-        const std::vector<double> &time_segments() const
+        double waiting_time_violation() const
         {
-            return _time_segments;
+            return _waiting_time_slack.violation();
         }
 
         /**
-         * @brief The waiting time violations of each customer in this route.
+         * @brief The waiting time slack of customers in this route. Time segments of drone routes do not depend on
+         * the departure time, so delays computed from them are exact.
          */
-        const std::vector<double> &waiting_time_violations() const
+        const WaitingTimeSlack &waiting_time_slack() const
         {
-            return _waiting_time_violations;
+            return _waiting_time_slack;
         }
 
         /**
@@ -370,46 +652,48 @@ namespace d2d
          */
         void push_back(const std::size_t &customer)
         {
-            std::vector<std::size_t> new_customers(_customers);
+            std::vector<std::size_t> new_customers(_customers.begin(), _customers.end());
             new_customers.insert(new_customers.end() - 1, customer);
             *this = DroneRoute(new_customers);
         }
     };
 
-    std::vector<double> DroneRoute::_calculate_time_segments(const std::vector<std::size_t> &customers)
+    template <typename _Container>
+    double DroneRoute::_calculate_time_segment(const _Container &customers, const std::size_t &i)
     {
-        auto problem = Problem::get_instance();
-        std::vector<double> time_segments;
+        return time_segment_between(customers[i], customers[i + 1]);
+    }
 
-        auto drone = problem->drone;
-        time_segments.reserve(customers.size() - 1);
+    template <typename _Container>
+    double DroneRoute::_calculate_working_time(const _Container &customers)
+    {
+        double working_time = 0;
         for (std::size_t i = 0; i + 1 < customers.size(); i++)
         {
-            time_segments.push_back(
-                problem->customers[customers[i]].drone_service_time +
-                drone->takeoff_time() +
-                drone->cruise_time(problem->distances[customers[i]][customers[i + 1]]) +
-                drone->landing_time());
+            working_time += _calculate_time_segment(customers, i);
         }
 
-        return time_segments;
+        return working_time;
     }
 
-    std::vector<double> DroneRoute::_calculate_waiting_time_violations(
-        const std::vector<std::size_t> &customers,
-        const std::vector<double> &time_segments)
+    template <typename _Container>
+    WaitingTimeSlack DroneRoute::_calculate_waiting_time_slack(const _Container &customers)
     {
         auto problem = Problem::get_instance();
-        return _BaseRoute::calculate_waiting_time_violations(
+        return WaitingTimeSlack(
             customers,
-            time_segments,
+            [&customers](const std::size_t &i)
+            {
+                return _calculate_time_segment(customers, i);
+            },
             [&problem](const std::size_t &customer)
             {
                 return problem->customers[customer].drone_service_time;
             });
     }
 
-    double DroneRoute::_calculate_energy_consumption(const std::vector<std::size_t> &customers)
+    template <typename _Container>
+    double DroneRoute::_calculate_energy_consumption(const _Container &customers)
     {
         auto problem = Problem::get_instance();
         double energy = 0, weight = 0;
@@ -426,12 +710,12 @@ namespace d2d
         return energy;
     }
 
-    double DroneRoute::_calculate_fixed_time_violation(const std::vector<double> &time_segments)
+    double DroneRoute::_calculate_fixed_time_violation(const double &working_time)
     {
         auto problem = Problem::get_instance();
         if (problem->endurance != nullptr)
         {
-            return std::max(0.0, std::accumulate(time_segments.begin(), time_segments.end(), 0.0) - problem->endurance->fixed_time);
+            return std::max(0.0, working_time - problem->endurance->fixed_time);
         }
 
         return 0;
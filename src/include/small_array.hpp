@@ -0,0 +1,208 @@
+#pragma once
+
+#include "utils.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A fixed-size array of trivially copyable elements, stored inline when it holds at most `N` elements
+     * and on the heap otherwise.
+     *
+     * The size is set at construction and never changes afterwards, so an array of `N` elements or less never
+     * allocates, even when copied.
+     */
+    template <typename T, std::size_t N>
+    class SmallArray
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SmallArray only supports trivially copyable elements");
+
+    private:
+        std::uint32_t _size;
+        union
+        {
+            T _inline[N];
+            T *_heap;
+        };
+
+        bool _is_inline() const
+        {
+            return _size <= N;
+        }
+
+        void _allocate(const std::size_t &size)
+        {
+            _size = size;
+            if (!_is_inline())
+            {
+                _heap = new T[size];
+            }
+        }
+
+        void _release()
+        {
+            if (!_is_inline())
+            {
+                delete[] _heap;
+            }
+
+            _size = 0;
+        }
+
+        void _steal(SmallArray &other)
+        {
+            _size = other._size;
+            if (_is_inline())
+            {
+                std::copy(other._inline, other._inline + _size, _inline);
+            }
+            else
+            {
+                _heap = other._heap;
+            }
+
+            other._size = 0;
+        }
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T *;
+        using const_iterator = const T *;
+
+        SmallArray() : _size(0) {}
+
+        template <typename _InputIt>
+        SmallArray(_InputIt first, _InputIt last)
+        {
+            _allocate(std::distance(first, last));
+            std::transform(
+                first, last, begin(),
+                [](const auto &value)
+                { return static_cast<T>(value); });
+        }
+
+        template <typename U, typename _Alloc>
+        explicit SmallArray(const std::vector<U, _Alloc> &values) : SmallArray(values.begin(), values.end()) {}
+
+        SmallArray(const SmallArray &other)
+        {
+            _allocate(other._size);
+            std::copy(other.begin(), other.end(), begin());
+        }
+
+        SmallArray(SmallArray &&other) noexcept
+        {
+            _steal(other);
+        }
+
+        SmallArray &operator=(const SmallArray &other)
+        {
+            if (this != &other)
+            {
+                if (_size != other._size)
+                {
+                    _release();
+                    _allocate(other._size);
+                }
+
+                std::copy(other.begin(), other.end(), begin());
+            }
+
+            return *this;
+        }
+
+        SmallArray &operator=(SmallArray &&other) noexcept
+        {
+            if (this != &other)
+            {
+                _release();
+                _steal(other);
+            }
+
+            return *this;
+        }
+
+        ~SmallArray()
+        {
+            _release();
+        }
+
+        std::size_t size() const
+        {
+            return _size;
+        }
+
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        T *data()
+        {
+            return _is_inline() ? _inline : _heap;
+        }
+
+        const T *data() const
+        {
+            return _is_inline() ? _inline : _heap;
+        }
+
+        iterator begin()
+        {
+            return data();
+        }
+
+        iterator end()
+        {
+            return data() + _size;
+        }
+
+        const_iterator begin() const
+        {
+            return data();
+        }
+
+        const_iterator end() const
+        {
+            return data() + _size;
+        }
+
+        T &operator[](const std::size_t &index)
+        {
+            return data()[index];
+        }
+
+        const T &operator[](const std::size_t &index) const
+        {
+            return data()[index];
+        }
+
+        const T &front() const
+        {
+            return data()[0];
+        }
+
+        const T &back() const
+        {
+            return data()[_size - 1];
+        }
+
+        bool operator==(const SmallArray &other) const
+        {
+            return std::equal(begin(), end(), other.begin(), other.end());
+        }
+    };
+}
+
+namespace std
+{
+    template <typename T, size_t N>
+    ostream &operator<<(ostream &stream, const utils::SmallArray<T, N> &_a)
+    {
+        stream << "[";
+        __list_elements(stream, _a.begin(), _a.end());
+        stream << "]";
+
+        return stream;
+    }
+}
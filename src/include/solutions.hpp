@@ -1,18 +1,23 @@
 #pragma once
 
+#include "async.hpp"
 #include "bitvector.hpp"
 #include "tsp_solver.hpp"
 #include "fp_specifier.hpp"
 #include "initial.hpp"
 #include "logger.hpp"
 #include "parent.hpp"
+#include "pool.hpp"
 #include "problem.hpp"
 #include "routes.hpp"
+#include "trips.hpp"
 #include "wrapper.hpp"
-#include "neighborhoods/cross_3.hpp"
 #include "neighborhoods/cross.hpp"
+#include "neighborhoods/cyclic_exchange.hpp"
 #include "neighborhoods/ejection_chain.hpp"
 #include "neighborhoods/move_xy.hpp"
+#include "neighborhoods/reassignment.hpp"
+#include "neighborhoods/swap_star.hpp"
 #include "neighborhoods/two_opt.hpp"
 
 namespace d2d
@@ -217,12 +222,22 @@ namespace d2d
     private:
         static double A1, A2, A3, A4, B;
 
-        static const std::vector<std::shared_ptr<Neighborhood<Solution, true>>> _neighborhoods;
+        /** @brief The tabu search neighborhoods, held by value so that `move` is dispatched statically. */
+        static std::tuple<
+            MoveXY<Solution, 1, 0>,
+            MoveXY<Solution, 1, 1>,
+            MoveXY<Solution, 2, 0>,
+            MoveXY<Solution, 2, 1>,
+            MoveXY<Solution, 2, 2>,
+            TwoOpt<Solution>,
+            SwapStar<Solution>>
+            _neighborhoods;
+
+        static std::atomic<std::size_t> _epoch_counter;
 
-        static std::vector<std::vector<std::vector<double>>> _calculate_truck_time_segments(
-            const std::vector<std::vector<TruckRoute>> &truck_routes);
         static std::vector<double> _calculate_truck_working_time(
-            const std::vector<std::vector<std::vector<double>>> &truck_time_segments);
+            const std::vector<std::vector<TruckRoute>> &truck_routes,
+            double &waiting_time_violation);
         static std::vector<double> _calculate_drone_working_time(
             const std::vector<std::vector<DroneRoute>> &drone_routes);
         static double _calculate_working_time(
@@ -233,15 +248,82 @@ namespace d2d
             const std::vector<std::vector<TruckRoute>> &truck_routes,
             const std::vector<std::vector<DroneRoute>> &drone_routes);
         static double _calculate_waiting_time_violation(
-            const std::vector<std::vector<TruckRoute>> &truck_routes,
-            const std::vector<std::vector<std::vector<double>>> &truck_time_segments,
+            const double &truck_waiting_time_violation,
             const std::vector<std::vector<DroneRoute>> &drone_routes);
         static double _calculate_fixed_time_violation(const std::vector<std::vector<DroneRoute>> &drone_routes);
 
-        const std::vector<std::vector<std::vector<double>>> _temp_truck_time_segments;
+        /** @brief Waiting time violation of truck routes, calculated along with their working time */
+        double _temp_truck_waiting_time_violation;
 
         const std::shared_ptr<ParentInfo<Solution>> _parent;
 
+        /** @brief An empty container recycled from a destroyed solution, keeping its capacity. */
+        template <typename T>
+        static T _take()
+        {
+            auto pool = utils::RecyclingPool<T>::local();
+            if (pool == nullptr)
+            {
+                return T();
+            }
+
+            auto result = pool->take();
+            result.clear();
+            return result;
+        }
+
+        /** @brief Copy `value` into a container recycled from a destroyed solution, reusing its buffers. */
+        template <typename T>
+        static T _recycled_copy(const T &value)
+        {
+            auto pool = utils::RecyclingPool<T>::local();
+            if (pool == nullptr)
+            {
+                return value;
+            }
+
+            // Assigning over existing elements reuses the buffers of nested containers as well
+            auto result = pool->take();
+            result.assign(value.begin(), value.end());
+            return result;
+        }
+
+        /** @brief Fresh modification epochs for `count` vehicles. */
+        static std::vector<std::size_t> _new_epochs(const std::size_t &count)
+        {
+            auto result = _take<std::vector<std::size_t>>();
+            for (std::size_t i = 0; i < count; i++)
+            {
+                result.push_back(_epoch_counter++);
+            }
+
+            return result;
+        }
+
+        /** @brief Modification epochs of a neighbor: vehicles modified in `scratch` get fresh epochs. */
+        template <typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>
+        static std::vector<std::size_t> _derive_epochs(const ScratchRoutes &scratch, const std::vector<std::size_t> &epochs)
+        {
+            auto result = _take<std::vector<std::size_t>>();
+            for (std::size_t i = 0; i < epochs.size(); i++)
+            {
+                result.push_back(scratch.modified<RT>(i) ? _epoch_counter++ : epochs[i]);
+            }
+
+            return result;
+        }
+
+        template <typename T>
+        static void _recycle(const T &value)
+        {
+            auto pool = utils::RecyclingPool<T>::local();
+            if (pool != nullptr)
+            {
+                // Const semantics do not apply to an object under destruction
+                pool->give(std::move(const_cast<T &>(value)));
+            }
+        }
+
         template <typename RT, std::enable_if_t<is_route_v<RT>, bool> = true>
         void _hamming_distance(const std::vector<std::vector<RT>> &vehicle_routes, std::vector<std::size_t> &repr) const
         {
@@ -252,7 +334,7 @@ namespace d2d
             {
                 for (auto &route : routes)
                 {
-                    const std::vector<std::size_t> &customers = route.customers();
+                    const auto &customers = route.customers();
                     for (std::size_t i = 1; i + 2 < customers.size(); i++)
                     {
                         auto current = customers[i], next = customers[i + 1];
@@ -293,6 +375,15 @@ namespace d2d
         /** @brief Routes of drones */
         const std::vector<std::vector<DroneRoute>> drone_routes;
 
+        /**
+         * @brief Modification epochs of trucks. A truck keeps its epoch in a neighbor solution if and only if its
+         * routes are unchanged.
+         */
+        const std::vector<std::size_t> truck_epochs;
+
+        /** @brief Modification epochs of drones */
+        const std::vector<std::size_t> drone_epochs;
+
         /** @brief Solution feasibility */
         const bool feasible;
 
@@ -301,17 +392,46 @@ namespace d2d
             const std::vector<std::vector<DroneRoute>> &drone_routes,
             const std::shared_ptr<ParentInfo<Solution>> parent,
             const bool debug_check = true)
-            : _temp_truck_time_segments(_calculate_truck_time_segments(truck_routes)),
+            : Solution(
+                  truck_routes,
+                  drone_routes,
+                  parent,
+                  _new_epochs(truck_routes.size()),
+                  _new_epochs(drone_routes.size()),
+                  debug_check) {}
+
+        /** @brief Construct the neighbor of `base` held by `scratch`, keeping the epochs of unmodified vehicles. */
+        Solution(
+            const ScratchRoutes &scratch,
+            const Solution &base,
+            const std::shared_ptr<ParentInfo<Solution>> parent)
+            : Solution(
+                  scratch.truck_routes,
+                  scratch.drone_routes,
+                  parent,
+                  _derive_epochs<TruckRoute>(scratch, base.truck_epochs),
+                  _derive_epochs<DroneRoute>(scratch, base.drone_epochs)) {}
+
+        Solution(
+            const std::vector<std::vector<TruckRoute>> &truck_routes,
+            const std::vector<std::vector<DroneRoute>> &drone_routes,
+            const std::shared_ptr<ParentInfo<Solution>> parent,
+            std::vector<std::size_t> &&truck_epochs,
+            std::vector<std::size_t> &&drone_epochs,
+            const bool debug_check = true)
+            : _temp_truck_waiting_time_violation(0),
               _parent(parent),
-              truck_working_time(_calculate_truck_working_time(_temp_truck_time_segments)),
+              truck_working_time(_calculate_truck_working_time(truck_routes, _temp_truck_waiting_time_violation)),
               drone_working_time(_calculate_drone_working_time(drone_routes)),
               working_time(_calculate_working_time(truck_working_time, drone_working_time)),
               drone_energy_violation(_calculate_energy_violation(drone_routes)),
               capacity_violation(_calculate_capacity_violation(truck_routes, drone_routes)),
-              waiting_time_violation(_calculate_waiting_time_violation(truck_routes, _temp_truck_time_segments, drone_routes)),
+              waiting_time_violation(_calculate_waiting_time_violation(_temp_truck_waiting_time_violation, drone_routes)),
               fixed_time_violation(_calculate_fixed_time_violation(drone_routes)),
-              truck_routes(truck_routes),
-              drone_routes(drone_routes),
+              truck_routes(_recycled_copy(truck_routes)),
+              drone_routes(_recycled_copy(drone_routes)),
+              truck_epochs(std::move(truck_epochs)),
+              drone_epochs(std::move(drone_epochs)),
               feasible(
                   utils::approximate(drone_energy_violation, 0.0) &&
                   utils::approximate(capacity_violation, 0.0) &&
@@ -366,6 +486,18 @@ namespace d2d
             }
         }
 
+        Solution(const Solution &) = default;
+
+        ~Solution()
+        {
+            _recycle(truck_working_time);
+            _recycle(drone_working_time);
+            _recycle(truck_routes);
+            _recycle(drone_routes);
+            _recycle(truck_epochs);
+            _recycle(drone_epochs);
+        }
+
         /** @brief The parent solution propagating this solution in the result tree */
         std::shared_ptr<ParentInfo<Solution>> parent() const
         {
@@ -389,6 +521,30 @@ namespace d2d
             return result + current_extra_penalty();
         }
 
+        /** @brief Working time and violations of some vehicles, from which the cost of a solution is bounded below */
+        struct PartialEvaluation
+        {
+            /** @brief Maximum working time of the vehicles */
+            double working_time = 0;
+
+            double drone_energy_violation = 0;
+            double capacity_violation = 0;
+            double waiting_time_violation = 0;
+            double fixed_time_violation = 0;
+
+            /** @brief Include a vehicle with the given routes. */
+            void add(const std::vector<TruckRoute> &routes);
+            void add(const std::vector<DroneRoute> &routes);
+        };
+
+        static PartialEvaluation evaluate_modified(const ScratchRoutes &scratch);
+        static double others_working_time(
+            const std::shared_ptr<Solution> &base,
+            const std::size_t &vehicle_i,
+            const std::size_t &vehicle_j);
+        static double cost_lower_bound(const double &others_working_time, const PartialEvaluation &evaluation);
+        static double cost_lower_bound(const std::shared_ptr<Solution> &base, const ScratchRoutes &scratch, const double &cutoff);
+
         double hamming_distance(const std::shared_ptr<Solution> other) const
         {
             std::vector<std::size_t> self_repr;
@@ -416,15 +572,18 @@ namespace d2d
             auto problem = Problem::get_instance();
             std::size_t iteration = 0;
 
-            std::vector<std::shared_ptr<BaseNeighborhood<Solution>>> inter_route, intra_route;
-            for (auto &neighborhood : _neighborhoods)
-            {
-                inter_route.push_back(neighborhood);
-                intra_route.push_back(neighborhood);
-            }
-            inter_route.push_back(std::make_shared<CrossExchange_3<Solution>>());
-            inter_route.push_back(std::make_shared<CrossExchange<Solution>>());
-            inter_route.push_back(std::make_shared<EjectionChain<Solution>>());
+            CyclicExchange<Solution> cyclic_exchange;
+            CrossExchange<Solution> cross_exchange;
+            EjectionChain<Solution> ejection_chain;
+            TripReassignment<Solution> trip_reassignment;
+
+            auto &[move_10, move_11, move_20, move_21, move_22, two_opt, swap_star] = _neighborhoods;
+            auto inter_route = std::tie(move_10, move_11, move_20, move_21, move_22, two_opt, swap_star, cyclic_exchange, cross_exchange, ejection_chain, trip_reassignment);
+            auto intra_route = std::tie(move_10, move_11, move_20, move_21, move_22, two_opt);
+
+            std::vector<std::size_t> inter_order(std::tuple_size_v<decltype(inter_route)>), intra_order(std::tuple_size_v<decltype(intra_route)>);
+            std::iota(inter_order.begin(), inter_order.end(), 0);
+            std::iota(intra_order.begin(), intra_order.end(), 0);
 
             auto result = std::make_shared<Solution>(*this);
             bool improved = true;
@@ -442,31 +601,41 @@ namespace d2d
             while (improved)
             {
                 improved = false;
-                std::shuffle(inter_route.begin(), inter_route.end(), utils::rng);
-                for (auto &neighborhood : inter_route)
+                std::shuffle(inter_order.begin(), inter_order.end(), utils::rng);
+                for (auto &index : inter_order)
                 {
                     if (problem->verbose)
                     {
                         std::cerr << utils::format("\rPost-optimize #%lu(%.2lf)", ++iteration, result->cost()) << std::flush;
                     }
 
-                    auto ptr = std::dynamic_pointer_cast<Neighborhood<Solution, true>>(neighborhood);
-                    if (ptr != nullptr)
-                    {
-                        ptr->clear();
-                    }
+                    utils::visit_at(
+                        inter_route, index,
+                        [&](auto &neighborhood)
+                        {
+                            constexpr bool tabu = std::is_base_of_v<Neighborhood<Solution, true>, std::remove_reference_t<decltype(neighborhood)>>;
+                            if constexpr (tabu)
+                            {
+                                neighborhood.clear();
+                            }
 
-                    neighborhood->inter_route(result, aspiration_criteria);
+                            neighborhood.set_aspiration_cutoff(result->cost().value);
+                            neighborhood.inter_route(result, aspiration_criteria);
 
 #ifdef LOGGING
-                    logger.log(
-                        result,
-                        result,
-                        {},
-                        std::make_pair(
-                            neighborhood->label() + "/post-optimization/inter-route",
-                            ptr == nullptr ? std::vector<std::size_t>() : ptr->last_tabu()));
+                            std::vector<std::size_t> last_tabu;
+                            if constexpr (tabu)
+                            {
+                                last_tabu = neighborhood.last_tabu();
+                            }
+
+                            logger.log(
+                                result,
+                                result,
+                                {},
+                                std::make_pair(neighborhood.label() + "/post-optimization/inter-route", last_tabu));
 #endif
+                        });
                 }
             }
 
@@ -474,31 +643,41 @@ namespace d2d
             while (improved)
             {
                 improved = false;
-                std::shuffle(intra_route.begin(), intra_route.end(), utils::rng);
-                for (auto &neighborhood : intra_route)
+                std::shuffle(intra_order.begin(), intra_order.end(), utils::rng);
+                for (auto &index : intra_order)
                 {
                     if (problem->verbose)
                     {
                         std::cerr << utils::format("\rPost-optimize #%lu(%.2lf)", ++iteration, result->cost()) << std::flush;
                     }
 
-                    auto ptr = std::dynamic_pointer_cast<Neighborhood<Solution, true>>(neighborhood);
-                    if (ptr != nullptr)
-                    {
-                        ptr->clear();
-                    }
+                    utils::visit_at(
+                        intra_route, index,
+                        [&](auto &neighborhood)
+                        {
+                            constexpr bool tabu = std::is_base_of_v<Neighborhood<Solution, true>, std::remove_reference_t<decltype(neighborhood)>>;
+                            if constexpr (tabu)
+                            {
+                                neighborhood.clear();
+                            }
 
-                    neighborhood->intra_route(result, aspiration_criteria);
+                            neighborhood.set_aspiration_cutoff(result->cost().value);
+                            neighborhood.intra_route(result, aspiration_criteria);
 
 #ifdef LOGGING
-                    logger.log(
-                        result,
-                        result,
-                        {},
-                        std::make_pair(
-                            neighborhood->label() + "/post-optimization/intra-route",
-                            ptr == nullptr ? std::vector<std::size_t>() : ptr->last_tabu()));
+                            std::vector<std::size_t> last_tabu;
+                            if constexpr (tabu)
+                            {
+                                last_tabu = neighborhood.last_tabu();
+                            }
+
+                            logger.log(
+                                result,
+                                result,
+                                {},
+                                std::make_pair(neighborhood.label() + "/post-optimization/intra-route", last_tabu));
 #endif
+                        });
                 }
             }
 
@@ -514,32 +693,46 @@ namespace d2d
                     {
                         RT old_route(route);
 
-                        std::vector<std::size_t> customers(route.customers());
-                        customers.pop_back();
-
-                        auto distance = [&problem, &customers](const std::size_t &i, const std::size_t &j)
+                        // Short drone routes take the best visiting order of their customers from the catalog
+                        const RT *trip = nullptr;
+                        if constexpr (std::is_same_v<RT, DroneRoute>)
                         {
-                            return problem->distances[customers[i]][customers[j]];
-                        };
-
-                        std::vector<std::size_t> ordered(customers.size());
-                        std::iota(ordered.begin(), ordered.end(), 0);
-                        ordered = customers.size() < 23 ? utils::held_karp_algorithm(customers.size(), distance).second
-                                                        : utils::two_opt_heuristic(customers.size(), distance, ordered).second;
-
-                        std::vector<std::size_t> new_customers(customers.size());
-                        std::transform(
-                            ordered.begin(), ordered.end(), new_customers.begin(),
-                            [&customers](const std::size_t &i)
-                            { return customers[i]; });
+                            trip = DroneTrips::get_instance().best(route.customers());
+                        }
 
-                        std::rotate(
-                            new_customers.begin(),
-                            std::find(new_customers.begin(), new_customers.end(), 0),
-                            new_customers.end());
+                        if (trip != nullptr)
+                        {
+                            route = *trip;
+                        }
+                        else
+                        {
+                            std::vector<std::size_t> customers(route.customers().begin(), route.customers().end());
+                            customers.pop_back();
 
-                        new_customers.push_back(0);
-                        route = RT(new_customers);
+                            auto distance = [&problem, &customers](const std::size_t &i, const std::size_t &j)
+                            {
+                                return problem->distances[customers[i]][customers[j]];
+                            };
+
+                            std::vector<std::size_t> ordered(customers.size());
+                            std::iota(ordered.begin(), ordered.end(), 0);
+                            ordered = customers.size() < 23 ? utils::held_karp_algorithm(customers.size(), distance).second
+                                                            : utils::two_opt_heuristic(customers.size(), distance, ordered).second;
+
+                            std::vector<std::size_t> new_customers(customers.size());
+                            std::transform(
+                                ordered.begin(), ordered.end(), new_customers.begin(),
+                                [&customers](const std::size_t &i)
+                                { return customers[i]; });
+
+                            std::rotate(
+                                new_customers.begin(),
+                                std::find(new_customers.begin(), new_customers.end(), 0),
+                                new_customers.end());
+
+                            new_customers.push_back(0);
+                            route = RT(new_customers);
+                        }
 
                         auto new_solution = std::make_shared<Solution>(new_truck_routes, new_drone_routes, parent);
                         if (!new_solution->feasible || new_solution->cost() >= result->cost())
@@ -581,50 +774,26 @@ namespace d2d
     double Solution::A4 = 1;
     double Solution::B = 1.5;
 
-    const std::vector<std::shared_ptr<Neighborhood<Solution, true>>> Solution::_neighborhoods = {
-        std::make_shared<MoveXY<Solution, 1, 0>>(),
-        std::make_shared<MoveXY<Solution, 1, 1>>(),
-        std::make_shared<MoveXY<Solution, 2, 0>>(),
-        std::make_shared<MoveXY<Solution, 2, 1>>(),
-        std::make_shared<MoveXY<Solution, 2, 2>>(),
-        std::make_shared<TwoOpt<Solution>>(),
-    };
+    decltype(Solution::_neighborhoods) Solution::_neighborhoods;
 
     ExtraPenalty Solution::extra_penalty;
 
-    std::vector<std::vector<std::vector<double>>> Solution::_calculate_truck_time_segments(
-        const std::vector<std::vector<TruckRoute>> &truck_routes)
-    {
-        std::vector<std::vector<std::vector<double>>> result(truck_routes.size());
-        for (std::size_t i = 0; i < truck_routes.size(); i++)
-        {
-            result[i].reserve(truck_routes[i].size());
-
-            std::size_t coefficients_index = 0;
-            double current_within_timespan = 0;
-            for (std::size_t j = 0; j < truck_routes[i].size(); j++)
-            {
-                result[i].push_back(TruckRoute::calculate_time_segments(
-                    truck_routes[i][j].customers(),
-                    coefficients_index,
-                    current_within_timespan));
-            }
-        }
+    std::atomic<std::size_t> Solution::_epoch_counter(1);
 
-        return result;
-    }
-
-    std::vector<double> Solution::_calculate_truck_working_time(const std::vector<std::vector<std::vector<double>>> &truck_time_segments)
+    std::vector<double> Solution::_calculate_truck_working_time(
+        const std::vector<std::vector<TruckRoute>> &truck_routes,
+        double &waiting_time_violation)
     {
-        std::vector<double> result;
-        result.reserve(truck_time_segments.size());
+        auto result = _take<std::vector<double>>();
+        result.reserve(truck_routes.size());
 
-        for (auto &routes : truck_time_segments)
+        for (auto &routes : truck_routes)
         {
-            double time = 0;
+            std::size_t coefficients_index = 0;
+            double current_within_timespan = 0, time = 0;
             for (auto &route : routes)
             {
-                time += std::accumulate(route.begin(), route.end(), 0.0);
+                time += TruckRoute::calculate_working_time(route.customers(), coefficients_index, current_within_timespan, waiting_time_violation);
             }
             result.push_back(time);
         }
@@ -634,7 +803,7 @@ namespace d2d
 
     std::vector<double> Solution::_calculate_drone_working_time(const std::vector<std::vector<DroneRoute>> &drone_routes)
     {
-        std::vector<double> result;
+        auto result = _take<std::vector<double>>();
         result.reserve(drone_routes.size());
 
         for (auto &routes : drone_routes)
@@ -701,28 +870,15 @@ namespace d2d
     }
 
     double Solution::_calculate_waiting_time_violation(
-        const std::vector<std::vector<TruckRoute>> &truck_routes,
-        const std::vector<std::vector<std::vector<double>>> &truck_time_segments,
+        const double &truck_waiting_time_violation,
         const std::vector<std::vector<DroneRoute>> &drone_routes)
     {
-        double result = 0;
-
-        for (std::size_t i = 0; i < truck_routes.size(); i++)
-        {
-            for (std::size_t j = 0; j < truck_routes[i].size(); j++)
-            {
-                auto waiting_time_violations = TruckRoute::calculate_waiting_time_violations(
-                    truck_routes[i][j].customers(),
-                    truck_time_segments[i][j]);
-                result += std::accumulate(waiting_time_violations.begin(), waiting_time_violations.end(), 0.0);
-            }
-        }
+        double result = truck_waiting_time_violation;
         for (auto &routes : drone_routes)
         {
             for (auto &route : routes)
             {
-                const std::vector<double> &waiting_time_violations = route.waiting_time_violations();
-                result += std::accumulate(waiting_time_violations.begin(), waiting_time_violations.end(), 0.0);
+                result += route.waiting_time_violation();
             }
         }
 
@@ -747,6 +903,169 @@ namespace d2d
         return result;
     }
 
+    void Solution::PartialEvaluation::add(const std::vector<TruckRoute> &routes)
+    {
+        std::size_t coefficients_index = 0;
+        double current_within_timespan = 0, time = 0;
+        for (auto &route : routes)
+        {
+            time += TruckRoute::calculate_working_time(route.customers(), coefficients_index, current_within_timespan, waiting_time_violation);
+            capacity_violation += route.capacity_violation();
+        }
+
+        working_time = std::max(working_time, time);
+    }
+
+    void Solution::PartialEvaluation::add(const std::vector<DroneRoute> &routes)
+    {
+        auto problem = Problem::get_instance();
+
+        double time = 0;
+        for (auto &route : routes)
+        {
+            time += route.working_time();
+            capacity_violation += route.capacity_violation();
+            waiting_time_violation += route.waiting_time_violation();
+            if (problem->endurance == nullptr)
+            {
+                drone_energy_violation += route.energy_violation();
+            }
+            else
+            {
+                fixed_time_violation += route.fixed_time_violation();
+            }
+        }
+
+        working_time = std::max(working_time, time);
+    }
+
+    /** @brief Evaluate the vehicles modified in `scratch`. */
+    Solution::PartialEvaluation Solution::evaluate_modified(const ScratchRoutes &scratch)
+    {
+        auto problem = Problem::get_instance();
+
+        PartialEvaluation result;
+        for (std::size_t truck = 0; truck < problem->trucks_count; truck++)
+        {
+            if (scratch.modified<TruckRoute>(truck))
+            {
+                result.add(scratch.truck_routes[truck]);
+            }
+        }
+        for (std::size_t drone = 0; drone < problem->drones_count; drone++)
+        {
+            if (scratch.modified<DroneRoute>(drone))
+            {
+                result.add(scratch.drone_routes[drone]);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Maximum working time of the vehicles of `base` other than `vehicle_i` and `vehicle_j` (indices among
+     * all vehicles, trucks first).
+     */
+    double Solution::others_working_time(
+        const std::shared_ptr<Solution> &base,
+        const std::size_t &vehicle_i,
+        const std::size_t &vehicle_j)
+    {
+        auto problem = Problem::get_instance();
+
+        double result = 0;
+        for (std::size_t truck = 0; truck < problem->trucks_count; truck++)
+        {
+            if (truck != vehicle_i && truck != vehicle_j)
+            {
+                result = std::max(result, base->truck_working_time[truck]);
+            }
+        }
+        for (std::size_t drone = 0; drone < problem->drones_count; drone++)
+        {
+            const auto vehicle = problem->trucks_count + drone;
+            if (vehicle != vehicle_i && vehicle != vehicle_j)
+            {
+                result = std::max(result, base->drone_working_time[drone]);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief A lower bound of the cost of a solution whose other vehicles work at most `others_working_time`, with
+     * the violations of these other vehicles left out.
+     */
+    double Solution::cost_lower_bound(const double &others_working_time, const PartialEvaluation &evaluation)
+    {
+        if (extra_penalty.is_diversifying())
+        {
+            // Edge penalties of diversification are not bounded below
+            return std::numeric_limits<double>::lowest();
+        }
+
+        return std::max(others_working_time, evaluation.working_time) +
+               A1 * evaluation.drone_energy_violation +
+               A2 * evaluation.capacity_violation +
+               A3 * evaluation.waiting_time_violation +
+               A4 * evaluation.fixed_time_violation;
+    }
+
+    /**
+     * @brief A lower bound of the cost of the neighbor of `base` held by `scratch`.
+     *
+     * Working time of unmodified vehicles is read from `base`, then modified vehicles are evaluated one by one
+     * and evaluation stops as soon as the bound reaches `cutoff`.
+     */
+    double Solution::cost_lower_bound(const std::shared_ptr<Solution> &base, const ScratchRoutes &scratch, const double &cutoff)
+    {
+        auto problem = Problem::get_instance();
+
+        double others = 0;
+        for (std::size_t truck = 0; truck < problem->trucks_count; truck++)
+        {
+            if (!scratch.modified<TruckRoute>(truck))
+            {
+                others = std::max(others, base->truck_working_time[truck]);
+            }
+        }
+        for (std::size_t drone = 0; drone < problem->drones_count; drone++)
+        {
+            if (!scratch.modified<DroneRoute>(drone))
+            {
+                others = std::max(others, base->drone_working_time[drone]);
+            }
+        }
+
+        PartialEvaluation modified;
+        for (std::size_t truck = 0; truck < problem->trucks_count; truck++)
+        {
+            if (scratch.modified<TruckRoute>(truck))
+            {
+                modified.add(scratch.truck_routes[truck]);
+                if (cost_lower_bound(others, modified) >= cutoff)
+                {
+                    return cost_lower_bound(others, modified);
+                }
+            }
+        }
+        for (std::size_t drone = 0; drone < problem->drones_count; drone++)
+        {
+            if (scratch.modified<DroneRoute>(drone))
+            {
+                modified.add(scratch.drone_routes[drone]);
+                if (cost_lower_bound(others, modified) >= cutoff)
+                {
+                    return cost_lower_bound(others, modified);
+                }
+            }
+        }
+
+        return cost_lower_bound(others, modified);
+    }
+
     std::array<double, 4> Solution::penalty_coefficients()
     {
         return {A1, A2, A3, A4};
@@ -755,18 +1074,32 @@ namespace d2d
     std::shared_ptr<Solution> Solution::tabu_search(Logger<Solution> &logger)
     {
         auto problem = Problem::get_instance();
-        std::vector<std::shared_ptr<Solution>> elite = {initial_impl<d2d::Solution, 1>(), initial_impl<d2d::Solution, 2>()};
-        auto current = elite[0]->cost() < elite[1]->cost() ? elite[0] : elite[1], result = current;
-
-        std::size_t base_hyperparameter = (problem->customers.size() - 1) /
-                                          (std::accumulate(
-                                               current->truck_routes.begin(), current->truck_routes.end(), 0,
-                                               [](const std::size_t &s, const std::vector<TruckRoute> &routes)
-                                               { return s + !routes.empty(); }) +
-                                           std::accumulate(
-                                               current->drone_routes.begin(), current->drone_routes.end(), 0,
-                                               [](const std::size_t &s, const std::vector<DroneRoute> &routes)
-                                               { return s + !routes.empty(); }));
+
+        // Initial solutions are constructed concurrently, the search starts from the first one available
+        utils::CompletionQueue<std::shared_ptr<Solution>> initial;
+        initial.submit(initial_impl<Solution, 1>);
+        initial.submit(initial_impl<Solution, 2>);
+        initial.submit(initial_impl<Solution, 3>);
+        for (std::size_t i = 0; i < problem->extra_initial; i++)
+        {
+            initial.submit(i % 2 == 0 ? initial_impl<Solution, 1> : initial_impl<Solution, 2>);
+        }
+
+        std::vector<std::shared_ptr<Solution>> elite;
+        auto current = *initial.wait(), result = current;
+
+        // Hyperparameters depend on the problem alone, not on whichever initial solution happens to finish first:
+        // customers are spread over all trucks, and over drones too unless no customer can be served by one
+        bool dronable = false;
+        for (std::size_t customer = 1; customer < problem->customers.size(); customer++)
+        {
+            dronable = dronable || problem->drone_serviceable[customer];
+        }
+
+        const std::size_t vehicles = std::min(
+            problem->customers.size() - 1,
+            problem->trucks_count + (dronable ? problem->drones_count : 0));
+        const std::size_t base_hyperparameter = std::max<std::size_t>(1, (problem->customers.size() - 1) / std::max<std::size_t>(1, vehicles));
 
         problem->tabu_size = base_hyperparameter;
         problem->reset_after = problem->reset_after_factor * base_hyperparameter;
@@ -783,23 +1116,37 @@ namespace d2d
         logger.iterations = 0;
 
         std::size_t neighborhood = 0;
-        auto insert_elite = [&problem, &elite, &result]()
+        TripReassignment<Solution> trip_reassignment;
+        auto insert_elite = [&problem, &elite](const std::shared_ptr<Solution> &ptr)
         {
             if (elite.size() == problem->max_elite_size)
             {
                 auto nearest = std::min_element(
                     elite.begin(), elite.end(),
-                    [&result](const std::shared_ptr<Solution> &first, const std::shared_ptr<Solution> &second)
+                    [&ptr](const std::shared_ptr<Solution> &first, const std::shared_ptr<Solution> &second)
                     {
-                        return result->hamming_distance(first) < result->hamming_distance(second);
+                        return ptr->hamming_distance(first) < ptr->hamming_distance(second);
                     });
 
                 elite.erase(nearest);
             }
 
-            elite.push_back(result);
+            elite.push_back(ptr);
+        };
+
+        auto absorb_initial = [&logger, &result, &insert_elite](const std::shared_ptr<Solution> &ptr, const std::size_t &iteration)
+        {
+            if (ptr->feasible && ptr->cost() < result->cost())
+            {
+                result = ptr;
+                logger.last_improved = iteration;
+            }
+
+            insert_elite(ptr);
         };
 
+        insert_elite(current);
+
         for (std::size_t iteration = 0;; iteration++)
         {
             extra_penalty.iteration_update();
@@ -831,13 +1178,18 @@ namespace d2d
 
             logger.iterations = iteration + 1;
 
+            for (auto &ptr : initial.poll())
+            {
+                absorb_initial(ptr, iteration);
+            }
+
             const auto aspiration_criteria = [&logger, &result, &insert_elite, &iteration](std::shared_ptr<Solution> ptr)
             {
                 if (ptr->feasible && ptr->cost() < result->cost() && (!result->feasible || ptr->working_time < result->working_time))
                 {
                     result = ptr;
                     logger.last_improved = iteration;
-                    insert_elite();
+                    insert_elite(result);
                     return true;
                 }
 
@@ -845,7 +1197,14 @@ namespace d2d
             };
 
             extra_penalty.set_base(current);
-            auto neighbor = _neighborhoods[neighborhood]->move(current, aspiration_criteria); // result is updated by aspiration_criteria
+            auto neighbor = utils::visit_at(
+                _neighborhoods, neighborhood,
+                [&current, &result, &aspiration_criteria](auto &n)
+                {
+                    n.set_aspiration_cutoff(result->cost().value);
+                    return Neighborhood<Solution, true>::move(n, current, aspiration_criteria); // result is updated by aspiration_criteria
+                });
+            utils::Arena::local().reset(); // Neighborhood scratch data does not outlive an iteration
             auto old_current = current;
             if (logger.last_improved == iteration)
             {
@@ -856,6 +1215,16 @@ namespace d2d
                 current = neighbor;
             }
 
+            // Periodically rebalance whole routes among vehicles of the current solution
+            if ((iteration + 1) % problem->tabu_size == 0)
+            {
+                auto rebalanced = trip_reassignment.inter_route(current, aspiration_criteria).first;
+                if (rebalanced != nullptr)
+                {
+                    current = rebalanced;
+                }
+            }
+
             extra_penalty.update(
                 old_current->truck_routes,
                 old_current->drone_routes,
@@ -867,7 +1236,13 @@ namespace d2d
             {
                 if (elite.empty())
                 {
-                    break;
+                    auto ptr = initial.wait();
+                    if (!ptr.has_value())
+                    {
+                        break;
+                    }
+
+                    absorb_initial(*ptr, iteration);
                 }
 
                 auto iter = utils::random_element(elite);
@@ -875,10 +1250,10 @@ namespace d2d
                 elite.erase(iter);
                 extra_penalty.start_diversification();
 
-                for (auto &neighborhood : _neighborhoods)
-                {
-                    neighborhood->clear();
-                }
+                std::apply(
+                    [](auto &...n)
+                    { (n.clear(), ...); },
+                    _neighborhoods);
             }
 
 #ifdef LOGGING
@@ -886,7 +1261,10 @@ namespace d2d
                 result,
                 current,
                 elite,
-                std::make_pair(_neighborhoods[neighborhood]->label(), _neighborhoods[neighborhood]->last_tabu()));
+                utils::visit_at(
+                    _neighborhoods, neighborhood,
+                    [](const auto &n)
+                    { return std::make_pair(n.label(), n.last_tabu()); }));
 #endif
 
             const auto violation_update = [](double &A, const double &violation)
@@ -911,7 +1289,7 @@ namespace d2d
             violation_update(A3, current->waiting_time_violation);
             violation_update(A4, current->fixed_time_violation);
 
-            neighborhood = utils::random<std::size_t>(0, _neighborhoods.size() - 1);
+            neighborhood = utils::random<std::size_t>(0, std::tuple_size_v<decltype(_neighborhoods)> - 1);
         }
 
         if (problem->verbose)
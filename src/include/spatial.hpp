@@ -0,0 +1,277 @@
+#pragma once
+
+#include "utils.hpp"
+
+namespace utils
+{
+    /**
+     * @brief A uniform grid over a set of 2D points, supporting removal and proximity queries.
+     *
+     * The cell size is chosen so that each cell holds about one point on average, hence nearest-neighbor
+     * queries take `O(1)` expected time on evenly spread points.
+     */
+    class GridIndex
+    {
+    private:
+        static constexpr std::size_t _absent = std::numeric_limits<std::size_t>::max();
+
+        std::vector<double> _x, _y;
+        double _min_x, _min_y, _cell;
+        std::size_t _columns, _rows, _size;
+
+        std::vector<std::vector<std::size_t>> _cells;
+        std::vector<std::size_t> _cell_of;
+
+        std::size_t _column(const double &x) const
+        {
+            return std::min<std::size_t>(std::max(0.0, (x - _min_x) / _cell), _columns - 1);
+        }
+
+        std::size_t _row(const double &y) const
+        {
+            return std::min<std::size_t>(std::max(0.0, (y - _min_y) / _cell), _rows - 1);
+        }
+
+        /**
+         * @brief Visit all cells whose Chebyshev distance from cell `(column, row)` is exactly `ring`.
+         *
+         * @return A lower bound of the squared distance from `(x, y)` to any point outside the visited rings.
+         */
+        template <typename _Callback>
+        double _visit_ring(const double &x, const double &y, const std::size_t &column, const std::size_t &row, const std::size_t &ring, const _Callback &callback) const
+        {
+            const long long c = column, r = row, d = ring;
+            for (long long i = c - d; i <= c + d; i++)
+            {
+                if (i < 0 || i >= static_cast<long long>(_columns))
+                {
+                    continue;
+                }
+
+                for (long long j = r - d; j <= r + d; j += (i == c - d || i == c + d) ? 1 : std::max(1ll, 2 * d))
+                {
+                    if (j >= 0 && j < static_cast<long long>(_rows))
+                    {
+                        for (auto &id : _cells[i * _rows + j])
+                        {
+                            callback(id);
+                        }
+                    }
+                }
+            }
+
+            double bound = std::min(
+                std::min(x - (_min_x + (c - d) * _cell), _min_x + (c + d + 1) * _cell - x),
+                std::min(y - (_min_y + (r - d) * _cell), _min_y + (r + d + 1) * _cell - y));
+
+            return bound > 0 ? bound * bound : 0;
+        }
+
+        std::size_t _max_ring() const
+        {
+            return std::max(_columns, _rows);
+        }
+
+        double _squared_distance(const std::size_t &id, const double &x, const double &y) const
+        {
+            return pow2(_x[id] - x) + pow2(_y[id] - y);
+        }
+
+    public:
+        /**
+         * @brief Construct a grid over the points `ids`.
+         *
+         * @param ids The identifiers of the points to index, each must be a valid index of `x` and `y`
+         * @param x The x-coordinates, indexed by point identifier
+         * @param y The y-coordinates, indexed by point identifier
+         */
+        GridIndex(const std::vector<std::size_t> &ids, const std::vector<double> &x, const std::vector<double> &y)
+            : _x(x), _y(y), _min_x(0), _min_y(0), _cell(1), _columns(1), _rows(1), _size(0), _cell_of(x.size(), _absent)
+        {
+            if (!ids.empty())
+            {
+                double max_x = x[ids[0]], max_y = y[ids[0]];
+                _min_x = max_x;
+                _min_y = max_y;
+                for (auto &id : ids)
+                {
+                    _min_x = std::min(_min_x, x[id]);
+                    _min_y = std::min(_min_y, y[id]);
+                    max_x = std::max(max_x, x[id]);
+                    max_y = std::max(max_y, y[id]);
+                }
+
+                const double width = max_x - _min_x, height = max_y - _min_y;
+                _cell = std::max(std::sqrt(width * height / ids.size()), std::max(width, height) / ids.size());
+                if (_cell <= 0)
+                {
+                    _cell = 1;
+                }
+
+                _columns = static_cast<std::size_t>(width / _cell) + 1;
+                _rows = static_cast<std::size_t>(height / _cell) + 1;
+            }
+
+            _cells.resize(_columns * _rows);
+            for (auto &id : ids)
+            {
+                insert(id);
+            }
+        }
+
+        /** @brief The number of points currently in the index. */
+        std::size_t size() const
+        {
+            return _size;
+        }
+
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        bool contains(const std::size_t &id) const
+        {
+            return _cell_of[id] != _absent;
+        }
+
+        /** @brief Add a point back to the index. No-op if the point is already present. */
+        void insert(const std::size_t &id)
+        {
+            if (!contains(id))
+            {
+                _cell_of[id] = _column(_x[id]) * _rows + _row(_y[id]);
+                _cells[_cell_of[id]].push_back(id);
+                _size++;
+            }
+        }
+
+        /** @brief Remove a point from the index. No-op if the point is absent. */
+        void remove(const std::size_t &id)
+        {
+            if (contains(id))
+            {
+                auto &cell = _cells[_cell_of[id]];
+                auto iter = std::find(cell.begin(), cell.end(), id);
+                std::iter_swap(iter, cell.end() - 1);
+                cell.pop_back();
+
+                _cell_of[id] = _absent;
+                _size--;
+            }
+        }
+
+        /**
+         * @brief Find the point nearest to `(x, y)`.
+         *
+         * @return The identifier of the nearest point, or `std::nullopt` if the index is empty
+         */
+        std::optional<std::size_t> nearest(const double &x, const double &y) const
+        {
+            if (empty())
+            {
+                return std::nullopt;
+            }
+
+            std::size_t best = _absent;
+            double best_distance = std::numeric_limits<double>::max();
+            const auto column = _column(x), row = _row(y);
+            for (std::size_t ring = 0; ring <= _max_ring(); ring++)
+            {
+                double bound = _visit_ring(
+                    x, y, column, row, ring,
+                    [this, &x, &y, &best, &best_distance](const std::size_t &id)
+                    {
+                        double d = _squared_distance(id, x, y);
+                        if (d < best_distance)
+                        {
+                            best = id;
+                            best_distance = d;
+                        }
+                    });
+
+                if (best != _absent && best_distance <= bound)
+                {
+                    break;
+                }
+            }
+
+            return best;
+        }
+
+        /**
+         * @brief Find the `k` points nearest to `(x, y)`, ordered by increasing distance.
+         */
+        std::vector<std::size_t> k_nearest(const double &x, const double &y, const std::size_t &k) const
+        {
+            // Max-heap of (squared distance, id)
+            std::vector<std::pair<double, std::size_t>> heap;
+            const auto column = _column(x), row = _row(y);
+            for (std::size_t ring = 0; ring <= _max_ring() && k > 0; ring++)
+            {
+                double bound = _visit_ring(
+                    x, y, column, row, ring,
+                    [this, &x, &y, &k, &heap](const std::size_t &id)
+                    {
+                        double d = _squared_distance(id, x, y);
+                        if (heap.size() < k)
+                        {
+                            heap.emplace_back(d, id);
+                            std::push_heap(heap.begin(), heap.end());
+                        }
+                        else if (d < heap.front().first)
+                        {
+                            std::pop_heap(heap.begin(), heap.end());
+                            heap.back() = std::make_pair(d, id);
+                            std::push_heap(heap.begin(), heap.end());
+                        }
+                    });
+
+                if (heap.size() == std::min(k, _size) && (heap.empty() || heap.front().first <= bound))
+                {
+                    break;
+                }
+            }
+
+            std::sort_heap(heap.begin(), heap.end());
+
+            std::vector<std::size_t> result(heap.size());
+            std::transform(
+                heap.begin(), heap.end(), result.begin(),
+                [](const std::pair<double, std::size_t> &p)
+                { return p.second; });
+
+            return result;
+        }
+
+        /**
+         * @brief Find all points within distance `radius` of `(x, y)`, in no particular order.
+         */
+        std::vector<std::size_t> within(const double &x, const double &y, const double &radius) const
+        {
+            std::vector<std::size_t> result;
+            if (empty() || radius < 0)
+            {
+                return result;
+            }
+
+            const auto column_begin = _column(x - radius), column_end = _column(x + radius),
+                       row_begin = _row(y - radius), row_end = _row(y + radius);
+            for (std::size_t i = column_begin; i <= column_end; i++)
+            {
+                for (std::size_t j = row_begin; j <= row_end; j++)
+                {
+                    for (auto &id : _cells[i * _rows + j])
+                    {
+                        if (_squared_distance(id, x, y) <= radius * radius)
+                        {
+                            result.push_back(id);
+                        }
+                    }
+                }
+            }
+
+            return result;
+        }
+    };
+}
@@ -2,20 +2,32 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <list>
 #include <map>
+#include <memory_resource>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <optional>
+#include <queue>
 #include <random>
 #include <set>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #if defined(_WIN32) && !defined(WIN32)
@@ -23,7 +35,7 @@
 #endif
 
 #if defined(WIN32)
-#define WIN32_LEAN_AND_MEAN // otherwise "rad1" macro in dlgs.h clashes with "rad1" variable in ALGLIB optimization.h
+#define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #elif defined(__linux__)
 #include <unistd.h>
@@ -32,8 +44,6 @@
 
 #include <cxxabi.h>
 
-#include <dataanalysis.h>
-
 namespace std
 {
     /**
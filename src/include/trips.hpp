@@ -0,0 +1,191 @@
+#pragma once
+
+#include "insertion.hpp"
+
+namespace d2d
+{
+    /**
+     * @brief A catalog of all feasible drone routes visiting at most `max_customers` customers, enumerated in
+     * parallel on first use.
+     *
+     * Drone routes are short, so most drone routes built by neighborhoods are found here: constructing one of
+     * them is then a copy of its entry instead of evaluating its time, energy and geometry again. The best
+     * visiting order of each customer set is recorded as well.
+     */
+    class DroneTrips
+    {
+    public:
+        static constexpr std::size_t max_customers = 3;
+
+    private:
+        static constexpr unsigned _bits = 21;
+
+        /** @brief Feasible routes keyed by their customers in visiting order */
+        std::unordered_map<std::uint64_t, DroneRoute> _routes;
+
+        /** @brief The key of the feasible route with the least working time, keyed by its sorted customers */
+        std::unordered_map<std::uint64_t, std::uint64_t> _best;
+
+        /** @brief Pack customers `[first, last)`, excluding the depot, into a key. */
+        template <typename _Iterator>
+        static std::uint64_t _key(const _Iterator &first, const _Iterator &last)
+        {
+            std::uint64_t key = 0;
+            for (auto it = first; it != last; it++)
+            {
+                key = (key << _bits) | *it;
+            }
+
+            return key;
+        }
+
+        DroneTrips()
+        {
+            auto problem = Problem::get_instance();
+            if (problem->customers.size() >= (std::size_t(1) << _bits))
+            {
+                return;
+            }
+
+            // Customer sets with pairwise compatible customers, each starting with its smallest customer
+            std::vector<std::vector<std::size_t>> sets;
+            for (std::size_t i = 1; i < problem->customers.size(); i++)
+            {
+                if (problem->drone_serviceable[i])
+                {
+                    sets.push_back({i});
+                }
+            }
+
+            for (std::size_t size = 1; size < max_customers; size++)
+            {
+                const auto count = sets.size();
+                for (std::size_t s = 0; s < count; s++)
+                {
+                    if (sets[s].size() != size)
+                    {
+                        continue;
+                    }
+
+                    for (std::size_t customer = sets[s].back() + 1; customer < problem->customers.size(); customer++)
+                    {
+                        if (std::all_of(
+                                sets[s].begin(), sets[s].end(),
+                                [&problem, &customer](const std::size_t &c)
+                                { return problem->drone_compatible[customer][c]; }))
+                        {
+                            auto set = sets[s];
+                            set.push_back(customer);
+                            sets.push_back(set);
+                        }
+                    }
+                }
+            }
+
+            // Evaluate every visiting order of each set, splitting the sets among threads
+            const std::size_t workers = std::max(1u, std::thread::hardware_concurrency());
+            std::vector<std::future<std::vector<DroneRoute>>> futures;
+            for (std::size_t worker = 0; worker < workers; worker++)
+            {
+                futures.push_back(
+                    std::async(
+                        std::launch::async,
+                        [&sets, worker, workers]()
+                        {
+                            std::vector<DroneRoute> routes;
+                            for (std::size_t s = worker; s < sets.size(); s += workers)
+                            {
+                                std::vector<std::size_t> customers(sets[s]);
+                                do
+                                {
+                                    std::vector<std::size_t> route = {0};
+                                    route.insert(route.end(), customers.begin(), customers.end());
+                                    route.push_back(0);
+
+                                    DroneRoute drone_route(route);
+                                    if (drone_route_feasible(drone_route))
+                                    {
+                                        routes.push_back(std::move(drone_route));
+                                    }
+                                } while (std::next_permutation(customers.begin(), customers.end()));
+                            }
+
+                            return routes;
+                        }));
+            }
+
+            for (auto &future : futures)
+            {
+                for (auto &route : future.get())
+                {
+                    const auto &customers = route.customers();
+                    const auto key = _key(customers.begin() + 1, customers.end() - 1);
+
+                    std::vector<std::size_t> sorted(customers.begin() + 1, customers.end() - 1);
+                    std::sort(sorted.begin(), sorted.end());
+
+                    // Ties are broken by the key, independently of the order in which routes are merged
+                    auto [best, inserted] = _best.emplace(_key(sorted.begin(), sorted.end()), key);
+                    if (!inserted)
+                    {
+                        const auto &other = _routes.at(best->second);
+                        if (std::make_pair(route.working_time(), key) < std::make_pair(other.working_time(), best->second))
+                        {
+                            best->second = key;
+                        }
+                    }
+
+                    _routes.emplace(key, std::move(route));
+                }
+            }
+        }
+
+    public:
+        static const DroneTrips &get_instance()
+        {
+            static const DroneTrips instance;
+            return instance;
+        }
+
+        /** @brief The number of feasible routes in the catalog. */
+        std::size_t size() const
+        {
+            return _routes.size();
+        }
+
+        /**
+         * @brief The feasible drone route visiting `customers` (including both depots) in order, or `nullptr` if
+         * there is none in the catalog.
+         */
+        template <typename _Container>
+        const DroneRoute *find(const _Container &customers) const
+        {
+            if (customers.size() < 3 || customers.size() > max_customers + 2)
+            {
+                return nullptr;
+            }
+
+            auto it = _routes.find(_key(customers.begin() + 1, customers.end() - 1));
+            return it == _routes.end() ? nullptr : &it->second;
+        }
+
+        /**
+         * @brief The feasible drone route with the least working time visiting the same customers as `customers`
+         * (including both depots) in any order, or `nullptr` if there is none in the catalog.
+         */
+        template <typename _Container>
+        const DroneRoute *best(const _Container &customers) const
+        {
+            if (customers.size() < 3 || customers.size() > max_customers + 2)
+            {
+                return nullptr;
+            }
+
+            std::vector<std::size_t> sorted(customers.begin() + 1, customers.end() - 1);
+            std::sort(sorted.begin(), sorted.end());
+
+            auto it = _best.find(_key(sorted.begin(), sorted.end()));
+            return it == _best.end() ? nullptr : &_routes.at(it->second);
+        }
+    };
+}
@@ -5,11 +5,12 @@
 
 namespace utils
 {
+    template <typename _Distance, std::enable_if_t<std::is_invocable_r_v<double, _Distance, std::size_t, std::size_t>, bool> = true>
     std::pair<double, std::size_t> __held_karp_solve(
         const std::size_t &n,
         const std::size_t &bitmask,
         const std::size_t &city,
-        const std::function<double(const std::size_t &, const std::size_t &)> &distance,
+        const _Distance &distance,
         std::vector<std::vector<std::pair<double, std::size_t>>> &dp)
     {
         if (dp[bitmask][city].first != -1.0)
@@ -44,9 +45,10 @@ namespace utils
         return dp[bitmask][city] = result;
     }
 
+    template <typename _Distance, std::enable_if_t<std::is_invocable_r_v<double, _Distance, std::size_t, std::size_t>, bool> = true>
     std::pair<double, std::vector<std::size_t>> __held_karp(
         const std::size_t &n,
-        const std::function<double(const std::size_t &, const std::size_t &)> &distance)
+        const _Distance &distance)
     {
         // https://en.wikipedia.org/wiki/Held-Karp_algorithm
         std::vector<std::vector<std::pair<double, std::size_t>>> dp(1u << n, std::vector<std::pair<double, std::size_t>>(n, {-1.0, n}));
@@ -81,9 +83,10 @@ namespace utils
         return {distance_end.first, path};
     }
 
+    template <typename _Distance, std::enable_if_t<std::is_invocable_r_v<double, _Distance, std::size_t, std::size_t>, bool> = true>
     std::pair<double, std::vector<std::size_t>> held_karp_algorithm(
         const std::size_t &n,
-        const std::function<double(const std::size_t &, const std::size_t &)> &distance)
+        const _Distance &distance)
     {
         if (n == 0)
         {
@@ -99,9 +102,10 @@ namespace utils
         return __held_karp(n, distance);
     }
 
+    template <typename _Distance, std::enable_if_t<std::is_invocable_r_v<double, _Distance, std::size_t, std::size_t>, bool> = true>
     std::pair<double, std::vector<std::size_t>> nearest_heuristic(
         const std::size_t &n,
-        const std::function<double(const std::size_t &, const std::size_t &)> &distance)
+        const _Distance &distance)
     {
         std::vector<std::size_t> path(n);
         std::iota(path.begin(), path.end(), 0);
@@ -130,9 +134,10 @@ namespace utils
         return std::make_pair(d, path);
     }
 
+    template <typename _Distance, std::enable_if_t<std::is_invocable_r_v<double, _Distance, std::size_t, std::size_t>, bool> = true>
     std::pair<double, std::vector<std::size_t>> two_opt_heuristic(
         const std::size_t &n,
-        const std::function<double(const std::size_t &, const std::size_t &)> &distance,
+        const _Distance &distance,
         const std::optional<std::vector<std::size_t>> initial = std::nullopt)
     {
         double dist = 0;
@@ -89,6 +89,25 @@ namespace utils
         }
     }
 
+    /** @brief Invoke `function` on the element at a runtime `index` of `tuple`. */
+    template <std::size_t I = 0, typename _Tuple, typename _Function>
+    decltype(auto) visit_at(_Tuple &tuple, const std::size_t &index, _Function &&function)
+    {
+        if constexpr (I + 1 < std::tuple_size_v<std::remove_const_t<_Tuple>>)
+        {
+            if (index != I)
+            {
+                return visit_at<I + 1>(tuple, index, std::forward<_Function>(function));
+            }
+        }
+        else if (index != I)
+        {
+            throw std::out_of_range(format("Tuple index %lu is out of range", index));
+        }
+
+        return function(std::get<I>(tuple));
+    }
+
     template <typename T>
     std::string type()
     {